@@ -0,0 +1,135 @@
+#include <new>
+
+#include "benchmark.hpp"
+
+/** @brief The number of heap allocations made through the global `operator new` */
+std::size_t allocations = 0;
+
+/**
+ * @brief Count an allocation and serve it from the process heap
+ *
+ * The heap functions are opaque to the compiler, so freeing with them does not trip `-Wmismatched-new-delete`.
+ * Every form of `operator new` goes through this function (and every `operator delete` through `deallocate`), so
+ * the pointer layout is the same whichever pair the library uses.
+ */
+void *allocate(const std::size_t size, const std::size_t alignment)
+{
+    allocations++;
+
+    // Over-allocate, align, and keep the pointer returned by the heap just before the aligned block
+    const auto raw = HeapAlloc(GetProcessHeap(), 0, size + alignment + sizeof(void *));
+    if (raw == NULL)
+    {
+        return NULL;
+    }
+
+    auto address = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void *);
+    address = (address + alignment - 1) / alignment * alignment;
+    reinterpret_cast<void **>(address)[-1] = raw;
+    return reinterpret_cast<void *>(address);
+}
+
+void deallocate(void *pointer) noexcept
+{
+    if (pointer != NULL)
+    {
+        HeapFree(GetProcessHeap(), 0, reinterpret_cast<void **>(pointer)[-1]);
+    }
+}
+
+void *allocate_or_throw(const std::size_t size, const std::size_t alignment)
+{
+    if (auto pointer = allocate(size, alignment))
+    {
+        return pointer;
+    }
+
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size) { return allocate_or_throw(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void *operator new[](std::size_t size) { return allocate_or_throw(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void *operator new(std::size_t size, std::align_val_t alignment) { return allocate_or_throw(size, static_cast<std::size_t>(alignment)); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return allocate_or_throw(size, static_cast<std::size_t>(alignment)); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept { return allocate(size, static_cast<std::size_t>(alignment)); }
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept { return allocate(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void *pointer) noexcept { deallocate(pointer); }
+void operator delete[](void *pointer) noexcept { deallocate(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { deallocate(pointer); }
+void operator delete[](void *pointer, std::size_t) noexcept { deallocate(pointer); }
+void operator delete(void *pointer, std::align_val_t) noexcept { deallocate(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { deallocate(pointer); }
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept { deallocate(pointer); }
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept { deallocate(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { deallocate(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { deallocate(pointer); }
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { deallocate(pointer); }
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { deallocate(pointer); }
+
+/** @brief A built-in command doing nothing, so that only the dispatch allocations are counted */
+class NopCommand : public liteshell::BaseCommand
+{
+public:
+    NopCommand()
+        : liteshell::BaseCommand(
+              "nop",
+              "Do nothing",
+              "",
+              liteshell::CommandConstraint("args", "Ignored arguments", false, true)
+                  .add_option("-a", "Ignored option")
+                  .add_option("-b", "Ignored option")
+                  .add_option(
+                      "--value",
+                      "Ignored option",
+                      liteshell::PositionalArgument("value", "Ignored value", false, true))) {}
+
+    DWORD run(const liteshell::Context &context)
+    {
+        benchmark::sink += context.tokens.size();
+        return 0;
+    }
+};
+
+int main()
+{
+    auto client = liteshell::Client::get_instance();
+    client->add_command<NopCommand>();
+    client->get_environment()->set_value("value", "7");
+
+    const std::vector<std::pair<std::string, std::string>> messages = {
+        {"no arguments", "nop"},
+        {"plain arguments", "  nop first -ab second  "},
+        {"variables", "nop $value ${value} -a --value $value $errorlevel"},
+    };
+
+    const std::size_t iterations = 1000;
+    for (auto &[name, message] : messages)
+    {
+        for (auto cached : {false, true})
+        {
+            client->clear_cache();
+            client->process_command(message);
+
+            const auto before = allocations;
+            for (std::size_t i = 0; i < iterations; i++)
+            {
+                if (!cached)
+                {
+                    client->clear_cache();
+                }
+
+                client->process_command(message);
+            }
+
+            std::cout << utils::format(
+                             "%-32s %-10s %6.1f allocations/command",
+                             name.c_str(), cached ? "cached" : "uncached", (double)(allocations - before) / iterations)
+                      << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "benchmark.hpp"
+
+int main()
+{
+    const std::size_t count = 100000;
+    std::vector<long long> values(count), other(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        values[i] = (i * 7919) % 1000 - 500;
+        other[i] = (i * 104729) % 1000 - 500;
+    }
+
+    benchmark::measure(
+        "array_sum (100000 elements)",
+        10000,
+        [&](std::size_t)
+        {
+            benchmark::sink += utils::array_sum(values);
+        });
+
+    benchmark::measure(
+        "array_max (100000 elements)",
+        10000,
+        [&](std::size_t)
+        {
+            benchmark::sink += utils::array_max(values);
+        });
+
+    benchmark::measure(
+        "array_dot (100000 elements)",
+        10000,
+        [&](std::size_t)
+        {
+            benchmark::sink += utils::array_dot(values, other);
+        });
+
+    benchmark::measure(
+        "array_histogram, 16 bins (100000 elements)",
+        1000,
+        [&](std::size_t)
+        {
+            benchmark::sink += utils::array_histogram(values, 16)[0];
+        });
+
+    liteshell::Environment environment;
+    environment.set_integer_array("arr", values);
+    benchmark::measure(
+        "get_integer_array (100000 elements)",
+        100,
+        [&](std::size_t)
+        {
+            benchmark::sink += environment.get_integer_array("arr").size();
+        });
+
+    benchmark::measure(
+        "set_integer_array (100000 elements)",
+        100,
+        [&](std::size_t)
+        {
+            environment.set_integer_array("arr", values);
+        });
+
+    benchmark::measure(
+        "set_integer_array, then write back on ${arr_0} (100000 elements)",
+        10,
+        [&](std::size_t)
+        {
+            environment.set_integer_array("arr", values);
+            benchmark::sink += environment.resolve("${arr_0}").size();
+        });
+
+    environment.set_integer_array("arr", values);
+    environment.set_value("plain_1", "42");
+    benchmark::measure(
+        "get_view, other variable while an array is stored",
+        1000000,
+        [&](std::size_t)
+        {
+            benchmark::sink += environment.get_view("plain_1").size();
+        });
+
+    return 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <all.hpp>
+
+namespace benchmark
+{
+    /** @brief Prevent the compiler from optimizing away the measured work */
+    volatile std::size_t sink = 0;
+
+    /**
+     * @brief Measure the average duration of an operation and print it to stdout
+     *
+     * @param name The name of the measurement
+     * @param iterations The number of times to invoke `operation`
+     * @param operation A callable accepting the iteration index
+     * @return The average duration of an operation in nanoseconds
+     */
+    template <typename F>
+    double measure(const std::string &name, const std::size_t iterations, const F &operation)
+    {
+        // Warm up caches and lazily built structures
+        for (std::size_t i = 0; i < std::min<std::size_t>(iterations, 1000); i++)
+        {
+            operation(i);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; i++)
+        {
+            operation(i);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        auto total = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        std::cout << utils::format("%-48s %12.1f ns/op (%u iterations)", name.c_str(), (double)total / iterations, iterations) << std::endl;
+        return (double)total / iterations;
+    }
+}
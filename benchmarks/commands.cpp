@@ -0,0 +1,63 @@
+#include "benchmark.hpp"
+#include "../src/initialize.hpp"
+
+int main()
+{
+    auto client = liteshell::Client::get_instance();
+    initialize(client.get());
+
+    utils::CaseInsensitiveMap<std::size_t> map;
+    std::vector<std::pair<std::string, std::size_t>> entries;
+    for (auto &command : client->walk_commands())
+    {
+        std::vector<std::string> names = {command->name};
+        names.insert(names.end(), command->aliases.begin(), command->aliases.end());
+        for (auto &name : names)
+        {
+            map[name] = entries.size();
+            entries.emplace_back(name, entries.size());
+        }
+    }
+
+    const utils::PerfectHashMap<std::size_t, true> table(entries);
+    std::cout << utils::format("%u names in %u slots", table.size(), table.capacity()) << std::endl;
+
+    // Names as typed: mixed case, and executables that are not built-in commands
+    std::vector<std::string> hits, misses = {"python", "git", "notepad.exe", "C:\\Windows\\System32\\cmd.exe", "x"};
+    for (auto &[name, _] : entries)
+    {
+        auto typed = name;
+        typed[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(typed[0])));
+        hits.push_back(typed);
+    }
+
+    const std::size_t iterations = 1000000;
+    for (auto &[kind, names] : {std::make_pair("hit", hits), std::make_pair("miss", misses)})
+    {
+        benchmark::measure(
+            utils::format("CaseInsensitiveMap::find, %s", kind),
+            iterations,
+            [&](std::size_t i)
+            {
+                benchmark::sink += map.find(names[i % names.size()]) != map.end();
+            });
+
+        benchmark::measure(
+            utils::format("PerfectHashMap::find, %s", kind),
+            iterations,
+            [&](std::size_t i)
+            {
+                benchmark::sink += table.find(names[i % names.size()]) != NULL;
+            });
+
+        benchmark::measure(
+            utils::format("Client::get_optional_command, %s", kind),
+            iterations,
+            [&](std::size_t i)
+            {
+                benchmark::sink += client->get_optional_command(names[i % names.size()]).has_value();
+            });
+    }
+
+    return 0;
+}
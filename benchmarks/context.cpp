@@ -0,0 +1,123 @@
+#include "benchmark.hpp"
+#include "../src/initialize.hpp"
+
+/** @brief Build a command line passing every argument of a constraint */
+std::string sample_line(const std::string &name, const liteshell::CommandConstraint &constraint)
+{
+    std::string line = name;
+    for (auto &argument : constraint.positional)
+    {
+        line += argument.many ? " 1 2" : " 1";
+    }
+
+    for (auto &option : constraint.get_options_vector())
+    {
+        line += " " + option.names()[0];
+        for (std::size_t i = 0; i < option.positional.size(); i++)
+        {
+            line += " 1";
+        }
+    }
+
+    return line;
+}
+
+int main()
+{
+    auto client = liteshell::Client::get_instance();
+    initialize(client.get());
+
+    const std::size_t iterations = 100000;
+    double total_bind = 0, total_access = 0, total_slots = 0;
+    for (auto &command : client->walk_commands())
+    {
+        const auto &constraint = command->constraint;
+        const auto line = sample_line(command->name, constraint);
+        std::vector<std::string> names;
+        for (auto &argument : constraint.positional)
+        {
+            names.push_back(argument.name);
+        }
+        for (auto &option : constraint.get_options_vector())
+        {
+            for (std::size_t i = 0; i < option.positional.size(); i++)
+            {
+                names.push_back(option.names()[0] + " " + option.positional[i].name);
+            }
+        }
+
+        auto tokens = utils::split(line);
+        total_bind += benchmark::measure(
+            utils::format("bind, %s", command->name.c_str()),
+            iterations,
+            [&](std::size_t)
+            {
+                benchmark::sink += liteshell::Context::get_context(client.get(), line, line, std::vector<std::string>(tokens), &constraint).tokens.size();
+            });
+
+        auto context = liteshell::Context::get_context(client.get(), line, line, std::vector<std::string>(tokens), &constraint);
+        total_access += benchmark::measure(
+            utils::format("access all arguments by name, %s", command->name.c_str()),
+            iterations,
+            [&](std::size_t)
+            {
+                for (auto &name : names)
+                {
+                    benchmark::sink += context.has(name) ? context.get(name).size() : 0;
+                }
+                for (auto &option : constraint.get_options_vector())
+                {
+                    benchmark::sink += context.has(option.names()[0]);
+                }
+            });
+
+        std::vector<liteshell::ArgumentSlot> slots;
+        for (auto &name : names)
+        {
+            slots.push_back(constraint.slot(name));
+        }
+        for (auto &option : constraint.get_options_vector())
+        {
+            slots.push_back(constraint.option_slot(&option));
+        }
+
+        total_slots += benchmark::measure(
+            utils::format("access all arguments by slot, %s", command->name.c_str()),
+            iterations,
+            [&](std::size_t)
+            {
+                for (auto &slot : slots)
+                {
+                    benchmark::sink += context.has(slot) ? context.get_all(slot).size() : 0;
+                }
+            });
+    }
+
+    // An absent optional argument, e.g. "cd" without a path
+    auto cd = *client->get_optional_command("cd");
+    auto context = liteshell::Context::get_context(client.get(), "cd", "cd", &cd->constraint);
+    benchmark::measure(
+        "absent argument, get + catch ArgumentMissingError",
+        iterations,
+        [&](std::size_t)
+        {
+            try
+            {
+                benchmark::sink += context.get("path").size();
+            }
+            catch (liteshell::ArgumentMissingError &)
+            {
+                benchmark::sink++;
+            }
+        });
+    benchmark::measure(
+        "absent argument, get_optional",
+        iterations,
+        [&](std::size_t)
+        {
+            benchmark::sink += context.get_optional("path").has_value() ? 0 : 1;
+        });
+
+    std::cout << utils::format("Total over all built-ins: bind %.1f ns, access by name %.1f ns, access by slot %.1f ns", total_bind, total_access, total_slots) << std::endl;
+    return 0;
+}
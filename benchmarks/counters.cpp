@@ -0,0 +1,111 @@
+#include <thread>
+
+#include "benchmark.hpp"
+
+int main()
+{
+    liteshell::Environment environment;
+    auto counters = environment.get_counters();
+
+    const std::size_t iterations = 1000000;
+    benchmark::measure(
+        "incr, lookup by name",
+        iterations,
+        [&](std::size_t)
+        {
+            counters->emplace("failures")++;
+        });
+
+    // Workers look up their counters once, then update them without any lock
+    for (std::size_t threads : {1, 2, 4, 8})
+    {
+        benchmark::measure(
+            utils::format("incr, %u worker(s) x 100000 updates, 2 counters", threads),
+            10,
+            [&](std::size_t)
+            {
+                std::vector<std::thread> workers;
+                for (std::size_t t = 0; t < threads; t++)
+                {
+                    workers.emplace_back(
+                        [&counters]()
+                        {
+                            auto &failures = counters->emplace("failures");
+                            auto &bytes = counters->emplace("bytes");
+                            for (std::size_t i = 0; i < 100000; i++)
+                            {
+                                failures.fetch_add(i & 1, std::memory_order_relaxed);
+                                bytes.fetch_add(i, std::memory_order_relaxed);
+                            }
+                        });
+                }
+
+                for (auto &worker : workers)
+                {
+                    worker.join();
+                }
+            });
+
+        benchmark::measure(
+            utils::format("emplace, %u worker(s) x 100000 lookups, 64 names", threads),
+            10,
+            [&](std::size_t)
+            {
+                std::vector<std::thread> workers;
+                for (std::size_t t = 0; t < threads; t++)
+                {
+                    workers.emplace_back(
+                        [&counters, t]()
+                        {
+                            char name[16];
+                            for (std::size_t i = 0; i < 100000; i++)
+                            {
+                                auto length = std::snprintf(name, sizeof(name), "job_%u", static_cast<unsigned>((i + t) % 64));
+                                counters->emplace(std::string_view(name, length)).fetch_add(1, std::memory_order_relaxed);
+                            }
+                        });
+                }
+
+                for (auto &worker : workers)
+                {
+                    worker.join();
+                }
+            });
+    }
+
+    // Shared string values are copied in and out under the lock of their shard
+    auto values = environment.get_shared_values();
+    for (std::size_t threads : {1, 2, 4, 8})
+    {
+        benchmark::measure(
+            utils::format("store/load, %u worker(s) x 100000 updates, 64 names", threads),
+            10,
+            [&](std::size_t)
+            {
+                std::vector<std::thread> workers;
+                for (std::size_t t = 0; t < threads; t++)
+                {
+                    workers.emplace_back(
+                        [&values, t]()
+                        {
+                            char name[16];
+                            const utils::SharedString status(std::string_view("running"));
+                            utils::SharedString result;
+                            for (std::size_t i = 0; i < 100000; i++)
+                            {
+                                auto length = std::snprintf(name, sizeof(name), "job_%u", static_cast<unsigned>((i + t) % 64));
+                                values->store(std::string_view(name, length), status);
+                                benchmark::sink += values->load(std::string_view(name, length), result);
+                            }
+                        });
+                }
+
+                for (auto &worker : workers)
+                {
+                    worker.join();
+                }
+            });
+    }
+
+    return 0;
+}
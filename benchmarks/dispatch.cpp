@@ -0,0 +1,82 @@
+#include "benchmark.hpp"
+
+/** @brief A built-in command doing nothing, to measure the dispatch overhead alone */
+class NopCommand : public liteshell::BaseCommand
+{
+public:
+    NopCommand()
+        : liteshell::BaseCommand(
+              "nop",
+              "Do nothing",
+              "",
+              liteshell::CommandConstraint("args", "Ignored arguments", false, true)
+                  .add_option("-a", "Ignored option")
+                  .add_option("-b", "Ignored option")
+                  .add_option(
+                      "--value",
+                      "Ignored option",
+                      liteshell::PositionalArgument("value", "Ignored value", false, true))) {}
+
+    DWORD run(const liteshell::Context &context)
+    {
+        benchmark::sink += context.tokens.size();
+        return 0;
+    }
+};
+
+int main()
+{
+    auto client = liteshell::Client::get_instance();
+    client->add_command<NopCommand>();
+    const auto command = NopCommand();
+
+    const std::vector<std::pair<std::string, std::string>> messages = {
+        {"0 arguments", "nop"},
+        {"3 arguments", "nop first -ab second"},
+        {"10 arguments", "nop 1 2 3 4 5 -a -b --value x 6"},
+    };
+
+    const std::size_t iterations = 100000;
+    for (auto &[name, message] : messages)
+    {
+        benchmark::measure(
+            utils::format("process_command, %s", name.c_str()),
+            iterations,
+            [&](std::size_t)
+            {
+                client->process_command(message);
+            });
+
+        benchmark::measure(
+            utils::format("process_command without cache, %s", name.c_str()),
+            iterations,
+            [&](std::size_t)
+            {
+                client->clear_cache();
+                client->process_command(message);
+            });
+
+        // The previous dispatch path: tokenize without a constraint, copy the constraint, then tokenize again
+        benchmark::measure(
+            utils::format("tokenize twice + copy constraint, %s", name.c_str()),
+            iterations,
+            [&](std::size_t)
+            {
+                auto context = liteshell::Context::get_context(client.get(), message, message);
+                auto constraint = command.constraint;
+                benchmark::sink += liteshell::Context::get_context(client.get(), context.message, message, &constraint).tokens.size();
+            });
+
+        benchmark::measure(
+            utils::format("tokenize once + bind, %s", name.c_str()),
+            iterations,
+            [&](std::size_t)
+            {
+                benchmark::sink += liteshell::Context::get_context(client.get(), message, message, utils::split(message), &command.constraint).tokens.size();
+            });
+    }
+
+    const auto statistics = client->get_cache_statistics();
+    std::cout << utils::format("Command cache: %u hits, %u misses", statistics.hits, statistics.misses) << std::endl;
+    return 0;
+}
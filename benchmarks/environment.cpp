@@ -0,0 +1,189 @@
+#include "benchmark.hpp"
+
+int main()
+{
+    for (std::size_t count : {10, 1000, 100000})
+    {
+        liteshell::Environment environment;
+        std::vector<std::string> names(count), messages(count);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            names[i] = utils::format("var_%u", i);
+            environment.set_value(names[i], std::to_string(i));
+        }
+
+        for (std::size_t i = 0; i < count; i++)
+        {
+            messages[i] = utils::format("echoln \"$%s + ${%s} = $$3\"", names[i].c_str(), names[(i * 7) % count].c_str());
+        }
+
+        const std::size_t iterations = 1000000;
+        benchmark::measure(
+            utils::format("get_value (%u variables)", count),
+            iterations,
+            [&](std::size_t i)
+            {
+                benchmark::sink += environment.get_value(names[(i * 31) % count]).size();
+            });
+
+        benchmark::measure(
+            utils::format("set_value, existing (%u variables)", count),
+            iterations,
+            [&](std::size_t i)
+            {
+                environment.set_value(names[(i * 31) % count], "value");
+            });
+
+        benchmark::measure(
+            utils::format("resolve, 2 references (%u variables)", count),
+            iterations / 10,
+            [&](std::size_t i)
+            {
+                benchmark::sink += environment.resolve(messages[(i * 31) % count]).size();
+            });
+
+        environment.push_scope();
+        benchmark::measure(
+            utils::format("get_value, 1 local scope (%u variables)", count),
+            iterations,
+            [&](std::size_t i)
+            {
+                benchmark::sink += environment.get_value(names[(i * 31) % count]).size();
+            });
+    }
+
+    // Local scopes assigning names used only once, whose storage is released by endlocal
+    {
+        liteshell::Environment environment;
+        benchmark::measure(
+            "push_scope + set_value, new name + pop_scope",
+            1000000,
+            [&](std::size_t i)
+            {
+                environment.push_scope();
+                environment.set_value(utils::format("local_%u", i), "1");
+                environment.pop_scope();
+            });
+    }
+
+    // Save and restore 100k variables through a snapshot file
+    {
+        liteshell::Environment source;
+        for (std::size_t i = 0; i < 100000; i++)
+        {
+            source.set_value(utils::format("var_%u", i), utils::format("value of variable %u", i));
+        }
+
+        const std::string path = "environment.snapshot";
+        benchmark::measure(
+            "save_snapshot (100000 variables)",
+            20,
+            [&](std::size_t)
+            {
+                benchmark::sink += source.save_snapshot(path);
+            });
+
+        benchmark::measure(
+            "load_snapshot (100000 variables)",
+            20,
+            [&](std::size_t)
+            {
+                liteshell::Environment target;
+                benchmark::sink += target.load_snapshot(path);
+            });
+
+        DeleteFileW(utils::utf_convert(path).c_str());
+
+        benchmark::measure(
+            "get_values (100000 variables)",
+            20,
+            [&](std::size_t)
+            {
+                benchmark::sink += source.get_values().size();
+            });
+
+        std::ostringstream output;
+        benchmark::measure(
+            "for_each_value + TableStream (100000 variables)",
+            20,
+            [&](std::size_t)
+            {
+                output.str("");
+                utils::TableStream displayer(output, {"Name", "Value"}, 256);
+                source.for_each_value(
+                    [](const std::string_view &)
+                    {
+                        return true;
+                    },
+                    [&displayer](const std::string_view &name, const std::string_view &value)
+                    {
+                        displayer.add_row({name, value});
+                    });
+
+                displayer.flush();
+                benchmark::sink += output.tellp();
+            });
+    }
+
+    // Build a 10 MB value line by line
+    liteshell::Environment environment;
+    const std::string line(99, 'x');
+    benchmark::measure(
+        "append_value, 100 bytes (up to 10 MB)",
+        100000,
+        [&](std::size_t i)
+        {
+            if (i == 0)
+            {
+                environment.set_value("out", "");
+            }
+
+            environment.append_value("out", line);
+            environment.append_value("out", "\n");
+        });
+
+    // The same, for a variable exported to subprocesses
+    liteshell::Environment exported;
+    exported.export_variable("out");
+    benchmark::measure(
+        "append_value, 100 bytes, exported (up to 10 MB)",
+        100000,
+        [&](std::size_t i)
+        {
+            if (i == 0)
+            {
+                exported.set_value("out", "");
+            }
+
+            exported.append_value("out", line);
+            exported.append_value("out", "\n");
+        });
+
+    benchmark::sink += exported.get_export_block() != NULL;
+
+    benchmark::measure(
+        "get_value, 10 MB",
+        100,
+        [&](std::size_t)
+        {
+            benchmark::sink += environment.get_value("out").size();
+        });
+
+    benchmark::measure(
+        "get_shared, 10 MB",
+        1000000,
+        [&](std::size_t)
+        {
+            benchmark::sink += environment.get_shared("out").size();
+        });
+
+    benchmark::measure(
+        "get_shared + substr, 10 MB",
+        1000000,
+        [&](std::size_t i)
+        {
+            benchmark::sink += environment.get_shared("out").substr(i % 1000, 100).view()[0];
+        });
+
+    return 0;
+}
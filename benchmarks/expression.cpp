@@ -0,0 +1,82 @@
+#include "benchmark.hpp"
+
+int main()
+{
+    const std::vector<std::string> expressions = {
+        "97 % 7",
+        "9 * 9",
+        "1949 + 18 * (38 - 91) / 6",
+        "-(1 + 2) * (3 - -4) % (5 + 6 * 7)",
+    };
+
+    liteshell::Environment environment;
+    for (auto &expression : expressions)
+    {
+        const std::size_t iterations = 1000000;
+        benchmark::measure(
+            utils::format("compile + evaluate \"%s\"", expression.c_str()),
+            iterations,
+            [&](std::size_t)
+            {
+                benchmark::sink += liteshell::Expression::compile(expression).evaluate(
+                    [](const std::string_view &)
+                    {
+                        return 0LL;
+                    });
+            });
+
+        benchmark::measure(
+            utils::format("eval_ll, cached \"%s\"", expression.c_str()),
+            iterations,
+            [&](std::size_t)
+            {
+                benchmark::sink += environment.eval_ll(expression);
+            });
+    }
+
+    // A loop over distinct texts, e.g. "$n % $div" resolved with a changing $div
+    std::vector<std::string> distinct(10000);
+    for (std::size_t i = 0; i < distinct.size(); i++)
+    {
+        distinct[i] = utils::format("1000003 %% %u", i + 2);
+    }
+
+    benchmark::measure(
+        "eval_ll, 10000 distinct expressions",
+        1000000,
+        [&](std::size_t i)
+        {
+            benchmark::sink += environment.eval_ll(distinct[i % distinct.size()]);
+        });
+
+    // The condition of tests/prime.ff: textual substitution vs bare identifiers
+    environment.set_value("n", "1000003");
+    environment.set_value("div", "997");
+    benchmark::measure(
+        "resolve + eval_ll \"$div * $div\"",
+        1000000,
+        [&](std::size_t)
+        {
+            benchmark::sink += environment.eval_ll(environment.resolve("$div * $div"));
+        });
+
+    benchmark::measure(
+        "eval_ll \"div * div\"",
+        1000000,
+        [&](std::size_t)
+        {
+            benchmark::sink += environment.eval_ll("div * div");
+        });
+
+    environment.set_value("done", "37");
+    environment.set_value("total", "120");
+    benchmark::measure(
+        "eval_d + format \"done / total * 100\"",
+        1000000,
+        [&](std::size_t)
+        {
+            benchmark::sink += utils::real_number(environment.eval_d("done / total * 100")).size();
+        });
+
+    return 0;
+}
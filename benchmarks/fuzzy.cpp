@@ -0,0 +1,171 @@
+#include "benchmark.hpp"
+#include "../src/initialize.hpp"
+
+/** @brief The previous implementation of `utils::fuzzy_search`, kept as the reference for the differential check */
+template <typename _ForwardIterator>
+_ForwardIterator legacy_fuzzy_search(const _ForwardIterator &first, const _ForwardIterator &last, const std::string &value)
+{
+    int n, m;
+    std::string compare;
+    std::vector<std::vector<int>> dp;
+
+    std::function<int(int, int)> distance;
+    distance = [&value, &n, &m, &compare, &dp, &distance](int value_index, int compare_index)
+    {
+        if (dp[value_index][compare_index] > -1)
+        {
+            return dp[value_index][compare_index];
+        }
+
+        int result = -1;
+        if (value_index == n)
+        {
+            result = m - compare_index;
+        }
+        else if (compare_index == m)
+        {
+            result = n - value_index;
+        }
+        else if (value[value_index] == compare[compare_index])
+        {
+            result = distance(value_index + 1, compare_index + 1);
+        }
+        else
+        {
+            result = 1 + std::min(
+                             distance(value_index, compare_index + 1),
+                             distance(value_index + 1, compare_index),
+                             distance(value_index + 1, compare_index + 1));
+        }
+
+        return dp[value_index][compare_index] = result;
+    };
+
+    int min_diff = INT_MAX;
+    _ForwardIterator result;
+    for (auto iter = first; iter != last; iter++)
+    {
+        compare = *iter;
+        n = value.size();
+        m = compare.size();
+        dp.clear();
+        dp.resize(n + 1, std::vector<int>(m + 1, -1));
+
+        int diff = distance(0, 0);
+        if (diff < min_diff)
+        {
+            min_diff = diff;
+            result = iter;
+        }
+    }
+
+    return result;
+}
+
+/** @brief The textbook Levenshtein distance, the reference for `utils::LevenshteinPattern` */
+std::size_t reference_distance(const std::string &first, const std::string &second)
+{
+    std::vector<std::vector<std::size_t>> dp(first.size() + 1, std::vector<std::size_t>(second.size() + 1));
+    for (std::size_t i = 0; i <= first.size(); i++)
+    {
+        for (std::size_t j = 0; j <= second.size(); j++)
+        {
+            if (i == 0 || j == 0)
+            {
+                dp[i][j] = i + j;
+            }
+            else
+            {
+                dp[i][j] = std::min(dp[i - 1][j - 1] + (first[i - 1] != second[j - 1]), dp[i - 1][j] + 1, dp[i][j - 1] + 1);
+            }
+        }
+    }
+
+    return dp[first.size()][second.size()];
+}
+
+std::string random_string(const std::size_t max_length)
+{
+    std::string result(utils::random<std::size_t>(0, max_length), ' ');
+    for (auto &c : result)
+    {
+        c = "abcde"[utils::random<std::size_t>(0, 4)];
+    }
+
+    return result;
+}
+
+/**
+ * @brief Compare `utils::LevenshteinPattern` with the textbook algorithm on random strings, with and without a cutoff,
+ * covering both the bit-parallel path and the fallback for patterns longer than 64 characters
+ *
+ * @return Whether all distances match
+ */
+bool differential_check(const std::size_t count)
+{
+    for (std::size_t i = 0; i < count; i++)
+    {
+        const auto first = random_string(i % 10 == 0 ? 100 : 20), second = random_string(i % 10 == 0 ? 100 : 20);
+        const auto cutoff = utils::random<std::size_t>(0, 30);
+
+        const auto expected = reference_distance(first, second);
+        const utils::LevenshteinPattern pattern(first);
+        if (pattern.distance(second) != expected || pattern.distance(second, cutoff) != std::min(expected, cutoff))
+        {
+            std::cout << utils::format(
+                             "Mismatch for \"%s\" and \"%s\" (cutoff %u): expected %u, got %u and %u",
+                             first.c_str(), second.c_str(), cutoff, expected, pattern.distance(second), pattern.distance(second, cutoff))
+                      << std::endl;
+            return false;
+        }
+    }
+
+    std::cout << utils::format("Differential check: %u random pairs match", count) << std::endl;
+    return true;
+}
+
+int main()
+{
+    if (!differential_check(100000))
+    {
+        return 1;
+    }
+
+    auto client = liteshell::Client::get_instance();
+    initialize(client.get());
+
+    std::vector<std::string> names;
+    for (auto &command : client->walk_commands())
+    {
+        names.push_back(command->name);
+        names.insert(names.end(), command->aliases.begin(), command->aliases.end());
+    }
+
+    const std::vector<std::string> typed = {"ecoh", "hepl", "notepad", "C:\\Windows\\System32\\WindowsPowerShell\\v1.0\\powershell.exe"};
+    for (auto &value : typed)
+    {
+        if (*legacy_fuzzy_search(names.begin(), names.end(), value) != *utils::fuzzy_search(names.begin(), names.end(), value))
+        {
+            std::cout << "Different suggestions for \"" << value << "\"" << std::endl;
+            return 1;
+        }
+
+        benchmark::measure(
+            utils::format("recursive dp, \"%s\"", value.substr(0, 24).c_str()),
+            1000,
+            [&](std::size_t)
+            {
+                benchmark::sink += legacy_fuzzy_search(names.begin(), names.end(), value)->size();
+            });
+
+        benchmark::measure(
+            utils::format("bit-parallel, \"%s\"", value.substr(0, 24).c_str()),
+            1000,
+            [&](std::size_t)
+            {
+                benchmark::sink += utils::fuzzy_search(names.begin(), names.end(), value)->size();
+            });
+    }
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "benchmark.hpp"
+
+/** @brief Spawn a process with an environment block and wait for it to exit */
+void spawn(const std::wstring &command, const wchar_t *environment_block)
+{
+    STARTUPINFOW startup_info;
+    ZeroMemory(&startup_info, sizeof(startup_info));
+    startup_info.cb = sizeof(startup_info);
+
+    std::wstring command_line(command);
+    PROCESS_INFORMATION process_info;
+    if (!CreateProcessW(
+            NULL, command_line.data(), NULL, NULL, TRUE,
+            environment_block == NULL ? 0 : CREATE_UNICODE_ENVIRONMENT,
+            (LPVOID)environment_block, NULL, &startup_info, &process_info))
+    {
+        throw std::runtime_error(utils::last_error("CreateProcessW ERROR"));
+    }
+
+    WaitForSingleObject(process_info.hProcess, INFINITE);
+    CloseHandle(process_info.hProcess);
+    CloseHandle(process_info.hThread);
+}
+
+int main()
+{
+    // Executables are built to build\, benchmarks to build\benchmarks\ (see scripts/benchmark.bat)
+    auto path = utils::get_executable_path();
+    path.resize(path.find_last_of('\\'));
+    path.resize(path.find_last_of('\\') + 1);
+
+    const auto command = utils::utf_convert(utils::format("\"%ssleep.exe\" 0", path.c_str()));
+
+    const std::size_t spawns = 200;
+    benchmark::measure(
+        "spawn, inherited environment",
+        spawns,
+        [&](std::size_t)
+        {
+            spawn(command, NULL);
+        });
+
+    for (std::size_t count : {10, 1000})
+    {
+        liteshell::Environment environment;
+        std::vector<std::string> names(count);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            names[i] = utils::format("var_%u", i);
+            environment.set_value(names[i], std::string(32, 'x'));
+            environment.export_variable(names[i]);
+        }
+
+        benchmark::measure(
+            utils::format("get_export_block, unchanged (%u exported)", count),
+            1000000,
+            [&](std::size_t)
+            {
+                benchmark::sink += (std::size_t)environment.get_export_block();
+            });
+
+        // Only the changed entry is spliced into the block, in place when its length is unchanged
+        benchmark::measure(
+            utils::format("get_export_block, 1 same-length change (%u exported)", count),
+            10000,
+            [&](std::size_t i)
+            {
+                environment.set_value(names[(i * 31) % count], std::string(32, 'a' + i % 26));
+                benchmark::sink += (std::size_t)environment.get_export_block();
+            });
+
+        benchmark::measure(
+            utils::format("get_export_block, 1 resizing change (%u exported)", count),
+            10000,
+            [&](std::size_t i)
+            {
+                environment.set_value(names[(i * 31) % count], std::string(i % 64, 'x'));
+                benchmark::sink += (std::size_t)environment.get_export_block();
+            });
+
+        benchmark::measure(
+            utils::format("spawn, unchanged (%u exported)", count),
+            spawns,
+            [&](std::size_t)
+            {
+                spawn(command, environment.get_export_block());
+            });
+
+        benchmark::measure(
+            utils::format("spawn, change one exported variable per spawn (%u exported)", count),
+            spawns,
+            [&](std::size_t i)
+            {
+                environment.set_value(names[(i * 31) % count], std::to_string(i));
+                spawn(command, environment.get_export_block());
+            });
+    }
+
+    return 0;
+}
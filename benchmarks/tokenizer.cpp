@@ -0,0 +1,70 @@
+#include "benchmark.hpp"
+
+/** @brief The previous implementation of `utils::split`, see also the differential check in tests/native/tokenizer.cpp */
+std::vector<std::string> legacy_split(const std::string &original)
+{
+    auto wstr = utils::utf_convert(original);
+
+    int size = 0;
+    auto results = CommandLineToArgvW(wstr.c_str(), &size);
+    if (results == NULL)
+    {
+        throw std::runtime_error(utils::last_error("CommandLineToArgvW ERROR"));
+    }
+
+    std::vector<std::string> args(size);
+    for (int i = 0; i < size; i++)
+    {
+        args[i] = utils::utf_convert(std::wstring(results[i]));
+    }
+
+    LocalFree(results);
+    return args;
+}
+
+int main()
+{
+    const std::vector<std::pair<std::string, std::string>> lines = {
+        {"plain", "ls -a --sort name C:\\Users\\liteshell\\Documents"},
+        {"quoted", "echo \"hello world\" \"C:\\Program Files\\\\\" \\\"literal\\\""},
+        {"long plain", "for 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29 30"},
+    };
+
+    const std::size_t iterations = 200000;
+    std::string buffer;
+    for (auto &[name, line] : lines)
+    {
+        const auto tokens = utils::tokenize(line, buffer).size();
+
+        auto legacy = benchmark::measure(
+            utils::format("CommandLineToArgvW, %s", name.c_str()),
+            iterations,
+            [&](std::size_t)
+            {
+                benchmark::sink += legacy_split(line).size();
+            });
+
+        auto views = benchmark::measure(
+            utils::format("tokenize, %s", name.c_str()),
+            iterations,
+            [&](std::size_t)
+            {
+                benchmark::sink += utils::tokenize(line, buffer).size();
+            });
+
+        auto strings = benchmark::measure(
+            utils::format("split, %s", name.c_str()),
+            iterations,
+            [&](std::size_t)
+            {
+                benchmark::sink += utils::split(line).size();
+            });
+
+        std::cout << utils::format(
+                         "%s (%u tokens): %.1fM tokens/s with CommandLineToArgvW, %.1fM with tokenize, %.1fM with split",
+                         name.c_str(), tokens, 1e3 * tokens / legacy, 1e3 * tokens / views, 1e3 * tokens / strings)
+                  << std::endl;
+    }
+
+    return 0;
+}
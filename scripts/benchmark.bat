@@ -0,0 +1,23 @@
+@echo off
+setlocal enabledelayedexpansion
+
+g++ --version
+
+for %%f in ("%~dp0..") do set root=%%~ff
+echo Got root of repository: %root%
+
+if not exist %root%\build\benchmarks mkdir %root%\build\benchmarks
+set before=-O3 -Wall -I %root%\extern\regex\include -I %root%\src\include -std=c++17
+set after=-l pathcch -l wininet
+
+for %%f in (%root%\benchmarks\*) do (
+    if "%%~xf" == ".cpp" (
+        echo Building %%f to %root%\build\benchmarks\%%~nf.exe
+        g++ %before% %%f %after% -o %root%\build\benchmarks\%%~nf.exe
+        if !errorlevel! neq 0 exit /b !errorlevel!
+
+        echo Running %root%\build\benchmarks\%%~nf.exe
+        %root%\build\benchmarks\%%~nf.exe
+        if !errorlevel! neq 0 exit /b !errorlevel!
+    )
+)
@@ -43,3 +43,12 @@ for %%f in (%root%\src\external\*) do (
         if !errorlevel! neq 0 exit /b !errorlevel!
     )
 )
+
+if not exist %root%\build\tests mkdir %root%\build\tests
+for %%f in (%root%\tests\native\*) do (
+    if "%%~xf" == ".cpp" (
+        echo Building %%f to %root%\build\tests\%%~nf.%extension%
+        g++ %before% %%f %after% -o %root%\build\tests\%%~nf.%extension%
+        if !errorlevel! neq 0 exit /b !errorlevel!
+    )
+)
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <all.hpp>
+
+struct _EndlocalArguments
+{
+    std::size_t depth;
+};
+
+class _EndlocalCommand : public liteshell::TypedCommand<_EndlocalCommand, _EndlocalArguments>
+{
+public:
+    static constexpr auto signature = liteshell::make_signature<_EndlocalArguments>(
+        liteshell::positional("depth", "", &_EndlocalArguments::depth));
+
+    _EndlocalCommand()
+        : liteshell::TypedCommand<_EndlocalCommand, _EndlocalArguments>(
+              "_endlocal",
+              "Hidden command",
+              "") {}
+
+    DWORD run(const liteshell::Context &context, const _EndlocalArguments &arguments)
+    {
+        const auto environment_ptr = context.client->get_environment();
+
+        // Keep the errorlevel of the script that just finished, which is assigned in the scopes below
+        const auto errorlevel = context.client->get_errorlevel();
+        const auto depth = arguments.depth;
+        while (environment_ptr->scope_depth() > depth)
+        {
+            environment_ptr->pop_scope();
+        }
+
+        return errorlevel;
+    }
+};
@@ -4,6 +4,40 @@
 
 class _IfCommand : public liteshell::BaseCommand
 {
+private:
+    const liteshell::ArgumentSlot _x_slot, _operator_slot, _y_slot, _true_slot, _false_slot, _f_slot, _m_slot;
+
+    template <typename T>
+    static bool _compare(const T &first, const std::string &op, const T &second)
+    {
+        if (op == "==")
+        {
+            return first == second;
+        }
+        else if (op == "!=")
+        {
+            return first != second;
+        }
+        else if (op == "<")
+        {
+            return first < second;
+        }
+        else if (op == ">")
+        {
+            return first > second;
+        }
+        else if (op == "<=")
+        {
+            return first <= second;
+        }
+        else if (op == ">=")
+        {
+            return first >= second;
+        }
+
+        throw std::invalid_argument("Invalid operator");
+    }
+
 public:
     _IfCommand()
         : liteshell::BaseCommand(
@@ -16,80 +50,38 @@ public:
                   "y", "", true,
                   "true", "", true,
                   "false", "", true)
-                  .add_option("-m", "", false))
+                  .add_option("-f", "", false)
+                  .add_option("-m", "", false)),
+          _x_slot(constraint.slot("x")),
+          _operator_slot(constraint.slot("operator")),
+          _y_slot(constraint.slot("y")),
+          _true_slot(constraint.slot("true")),
+          _false_slot(constraint.slot("false")),
+          _f_slot(constraint.slot("-f")),
+          _m_slot(constraint.slot("-m"))
     {
     }
 
     DWORD run(const liteshell::Context &context)
     {
-        auto first = context.get("x"), op = context.get("operator"), second = context.get("y");
+        auto first = context.get(_x_slot), op = context.get(_operator_slot), second = context.get(_y_slot);
+        const auto environment_ptr = context.client->get_environment();
+
         bool result;
-        if (context.present.count("-m"))
+        if (context.has(_f_slot))
+        {
+            result = _compare(environment_ptr->eval_d(first), op, environment_ptr->eval_d(second));
+        }
+        else if (context.has(_m_slot))
         {
-            auto f = context.client->get_environment()->eval_ll(first),
-                 s = context.client->get_environment()->eval_ll(second);
-            if (op == "==")
-            {
-                result = f == s;
-            }
-            else if (op == "!=")
-            {
-                result = f != s;
-            }
-            else if (op == "<")
-            {
-                result = f < s;
-            }
-            else if (op == ">")
-            {
-                result = f > s;
-            }
-            else if (op == "<=")
-            {
-                result = f <= s;
-            }
-            else if (op == ">=")
-            {
-                result = f >= s;
-            }
-            else
-            {
-                throw std::invalid_argument("Invalid operator");
-            }
+            result = _compare(environment_ptr->eval_ll(first), op, environment_ptr->eval_ll(second));
         }
         else
         {
-            if (op == "==")
-            {
-                result = first == second;
-            }
-            else if (op == "!=")
-            {
-                result = first != second;
-            }
-            else if (op == "<")
-            {
-                result = first < second;
-            }
-            else if (op == ">")
-            {
-                result = first > second;
-            }
-            else if (op == "<=")
-            {
-                result = first <= second;
-            }
-            else if (op == ">=")
-            {
-                result = first >= second;
-            }
-            else
-            {
-                throw std::invalid_argument("Invalid operator");
-            }
+            result = _compare(first, op, second);
         }
 
-        context.client->get_stream()->jump(context.get(result ? "true" : "false"));
+        context.client->get_stream()->jump(context.get(result ? _true_slot : _false_slot));
 
         return 0;
     }
@@ -4,6 +4,9 @@
 
 class ArrayCommand : public liteshell::BaseCommand
 {
+private:
+    const liteshell::ArgumentSlot _var_slot, _tokens_slot;
+
 public:
     ArrayCommand()
         : liteshell::BaseCommand(
@@ -15,14 +18,16 @@ public:
               "For example, \"array a 1 2 abc x y z\" gives a_0 = 1, a_1 = 2, a_2 = abc and so on.",
               liteshell::CommandConstraint(
                   "var", "Base variable name", true,
-                  "tokens", "The tokens to store", true, true))
+                  "tokens", "The tokens to store", true, true)),
+          _var_slot(constraint.slot("var")),
+          _tokens_slot(constraint.slot("tokens"))
     {
     }
 
     DWORD run(const liteshell::Context &context)
     {
-        const auto base_name = context.get("var");
-        const auto tokens = context.values.at("tokens");
+        const auto base_name = context.get(_var_slot);
+        const auto tokens = context.get_all(_tokens_slot);
 
         const auto environment_ptr = context.client->get_environment();
         environment_ptr->set_value(base_name, std::to_string(tokens.size()));
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <all.hpp>
+
+class ArrayopCommand : public liteshell::BaseCommand
+{
+private:
+    const liteshell::ArgumentSlot _operation_slot, _operands_slot, _s_slot, _s_var_slot;
+
+    static void _expect_operands(const std::string &operation, const liteshell::ArgumentValues &operands, const std::size_t count)
+    {
+        if (operands.size() != count)
+        {
+            throw std::invalid_argument(
+                utils::format(
+                    "\"%s\" expects %u operand(s), got %u",
+                    operation.c_str(), count, operands.size()));
+        }
+    }
+
+public:
+    ArrayopCommand()
+        : liteshell::BaseCommand(
+              "arrayop",
+              "Perform whole-array integer operations",
+              "Arrays are stored as by the \"array\" command. Supported operations:\n"
+              "- sum <arr>, min <arr>, max <arr>, dot <arr> <arr>: print the result, or store it to -s <var>\n"
+              "- add <arr> <arr>, mul <arr> <arr>: element-wise addition/multiplication\n"
+              "- scale <arr> <factor>: multiply all elements with an integer\n"
+              "- prefix-sum <arr>: replace each element with the sum of all elements up to it\n"
+              "- histogram <arr> <bins>: count the elements in <bins> equal-width bins between the minimum and\n"
+              "  the maximum element\n"
+              "Operations producing an array store it to -s <var>, or replace the first array.",
+              liteshell::CommandConstraint(
+                  "operation", "The operation to perform", true,
+                  "operands", "The array names or integers to operate on", true, true)
+                  .add_option(
+                      "-s",
+                      "Save the result to this variable (or array) instead",
+                      liteshell::PositionalArgument("var", "The variable name", false, true))),
+          _operation_slot(constraint.slot("operation")),
+          _operands_slot(constraint.slot("operands")),
+          _s_slot(constraint.slot("-s")),
+          _s_var_slot(constraint.slot("-s var"))
+    {
+    }
+
+    DWORD run(const liteshell::Context &context)
+    {
+        const auto operation = context.get(_operation_slot);
+        const auto operands = context.get_all(_operands_slot);
+        const auto environment_ptr = context.client->get_environment();
+
+        static const std::set<std::string> operations = {"add", "dot", "histogram", "max", "min", "mul", "prefix-sum", "scale", "sum"};
+        if (operations.count(operation) == 0)
+        {
+            throw std::invalid_argument(utils::format("Unknown operation \"%s\"", operation.c_str()));
+        }
+
+        std::string target = operands[0];
+        if (context.has(_s_slot))
+        {
+            target = context.get(_s_var_slot);
+        }
+        if (!utils::is_valid_variable(target))
+        {
+            throw std::invalid_argument(utils::format("Invalid variable name \"%s\"", target.c_str()));
+        }
+
+        std::optional<long long> scalar;
+        auto values = environment_ptr->get_integer_array(operands[0]);
+        if (operation == "sum" || operation == "min" || operation == "max")
+        {
+            _expect_operands(operation, operands, 1);
+            scalar = operation == "sum" ? utils::array_sum(values) : (operation == "min" ? utils::array_min(values) : utils::array_max(values));
+        }
+        else if (operation == "dot")
+        {
+            _expect_operands(operation, operands, 2);
+            scalar = utils::array_dot(values, environment_ptr->get_integer_array(operands[1]));
+        }
+        else if (operation == "add" || operation == "mul")
+        {
+            _expect_operands(operation, operands, 2);
+            auto other = environment_ptr->get_integer_array(operands[1]);
+            if (operation == "add")
+            {
+                utils::array_add(values, other);
+            }
+            else
+            {
+                utils::array_multiply(values, other);
+            }
+        }
+        else if (operation == "scale")
+        {
+            _expect_operands(operation, operands, 2);
+            utils::array_scale(values, utils::parse_integer(operands[1]));
+        }
+        else if (operation == "prefix-sum")
+        {
+            _expect_operands(operation, operands, 1);
+            utils::array_prefix_sum(values);
+        }
+        else // histogram
+        {
+            _expect_operands(operation, operands, 2);
+            auto bins = utils::parse_integer(operands[1]);
+            if (bins <= 0)
+            {
+                throw std::invalid_argument("The number of bins must be positive");
+            }
+
+            values = utils::array_histogram(values, bins);
+        }
+
+        if (!scalar.has_value())
+        {
+            environment_ptr->set_integer_array(target, std::move(values));
+        }
+        else if (context.has(_s_slot))
+        {
+            environment_ptr->set_value(target, std::to_string(*scalar));
+        }
+        else
+        {
+            std::cout << *scalar << std::endl;
+        }
+
+        return 0;
+    }
+};
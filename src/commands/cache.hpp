@@ -0,0 +1,44 @@
+#pragma once
+
+#include <all.hpp>
+
+class CacheCommand : public liteshell::BaseCommand
+{
+private:
+    const liteshell::ArgumentSlot _clear_slot;
+
+public:
+    CacheCommand()
+        : liteshell::BaseCommand(
+              "cache",
+              "Display the statistics of the parsed command line cache",
+              "Built-in command lines are cached after variable resolution, so that running the same line again skips\n"
+              "tokenizing, the command lookup and argument binding.",
+              liteshell::CommandConstraint().add_option("--clear", "Remove all cached command lines")),
+          _clear_slot(constraint.slot("--clear")) {}
+
+    DWORD run(const liteshell::Context &context)
+    {
+        if (context.has(_clear_slot))
+        {
+            context.client->clear_cache();
+            return 0;
+        }
+
+        // This command line is counted as a lookup itself
+        const auto statistics = context.client->get_cache_statistics();
+        const auto lookups = statistics.hits + statistics.misses;
+
+        auto display = utils::Table("Attribute", "Value");
+        display.add_row("Entries", utils::format("%u/%u", statistics.size, statistics.capacity));
+        display.add_row("Hits", std::to_string(statistics.hits));
+        display.add_row("Misses", std::to_string(statistics.misses));
+        display.add_row("Hit rate", lookups == 0 ? "-" : utils::format("%.1lf%%", 100.0 * statistics.hits / lookups));
+        display.add_row("Evictions", std::to_string(statistics.evictions));
+        display.add_row("Memory usage", utils::memory_size(statistics.memory));
+
+        std::cout << display.display() << std::endl;
+
+        return 0;
+    }
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <all.hpp>
+
+class CallCommand : public liteshell::BaseCommand
+{
+private:
+    const liteshell::ArgumentSlot _script_slot;
+
+public:
+    CallCommand()
+        : liteshell::BaseCommand(
+              "call",
+              "Run a batch script within a local scope",
+              "The script is executed as if it began with \"setlocal\": all variables it assigns are discarded when\n"
+              "it reaches its end, while the variables of the caller remain visible to it.",
+              liteshell::CommandConstraint("script", "The batch script to run", true)),
+          _script_slot(constraint.slot("script")) {}
+
+    DWORD run(const liteshell::Context &context)
+    {
+        const auto script = context.get(_script_slot);
+        const auto path = context.client->resolve(script);
+        if (!path.has_value() || !utils::endswith(*path, LITE_SHELL_SCRIPT_EXTENSION))
+        {
+            throw std::invalid_argument(utils::format("Cannot find a batch script from \"%s\"", script.c_str()));
+        }
+
+        context.client->process_batch_file(*path, true);
+        return 0;
+    }
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <all.hpp>
+
+class CasCommand : public liteshell::BaseCommand
+{
+private:
+    const liteshell::ArgumentSlot _name_slot, _expected_slot, _desired_slot;
+
+public:
+    CasCommand()
+        : liteshell::BaseCommand(
+              "cas",
+              "Atomically compare and swap the value of a shared counter",
+              "Set the counter to <desired> only if it currently equals <expected>. The errorlevel is set to 0 if\n"
+              "the counter was updated, or 1 otherwise. See \"incr\" for more information about counters.",
+              liteshell::CommandConstraint(
+                  "name", "The name of the counter", true,
+                  "expected", "The expected value of the counter", true,
+                  "desired", "The new value of the counter", true)),
+          _name_slot(constraint.slot("name")),
+          _expected_slot(constraint.slot("expected")),
+          _desired_slot(constraint.slot("desired")) {}
+
+    DWORD run(const liteshell::Context &context)
+    {
+        const auto name = context.get(_name_slot);
+        if (!utils::is_valid_variable(name))
+        {
+            throw std::invalid_argument(utils::format("Invalid variable name \"%s\"", name.c_str()));
+        }
+
+        auto expected = utils::parse_integer(context.get(_expected_slot));
+        const auto desired = utils::parse_integer(context.get(_desired_slot));
+        return context.client->get_environment()->get_counter(name).compare_exchange_strong(expected, desired) ? 0 : 1;
+    }
+};
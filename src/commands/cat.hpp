@@ -4,6 +4,9 @@
 
 class CatCommand : public liteshell::BaseCommand
 {
+private:
+    const liteshell::ArgumentSlot _file_slot;
+
 public:
     CatCommand()
         : liteshell::BaseCommand(
@@ -11,14 +14,15 @@ public:
               "Read a file",
               "Displays the content of a text file.",
               {"type"},
-              liteshell::CommandConstraint("file", "The file to read", true))
+              liteshell::CommandConstraint("file", "The file to read", true)),
+          _file_slot(constraint.slot("file"))
     {
     }
 
     DWORD run(const liteshell::Context &context)
     {
         auto file = CreateFileW(
-            utils::utf_convert(context.get("file")).c_str(),
+            utils::utf_convert(context.get(_file_slot)).c_str(),
             GENERIC_READ,
             FILE_SHARE_READ,
             NULL,
@@ -4,6 +4,9 @@
 
 class CdCommand : public liteshell::BaseCommand
 {
+private:
+    const liteshell::ArgumentSlot _path_slot;
+
 public:
     CdCommand()
         : liteshell::BaseCommand(
@@ -13,23 +16,21 @@ public:
               "Call this command with no argument to get the working directory (similar to Unix shell's \"pwd\").\n"
               "When a positional argument is provided, the shell will attempt to change the working directory to\n"
               "the specified path. If the path is not found, an error will be returned.",
-              liteshell::CommandConstraint("path", "The path to change the working directory to", false))
+              liteshell::CommandConstraint("path", "The path to change the working directory to", false)),
+          _path_slot(constraint.slot("path"))
     {
     }
 
     DWORD run(const liteshell::Context &context)
     {
-        try
+        auto path = context.get_optional(_path_slot);
+        if (path.has_value())
         {
-            auto target = context.get("path");
-            if (!SetCurrentDirectoryW(utils::utf_convert(target).c_str()))
-            {
-                throw std::runtime_error(utils::last_error(utils::format("Error when changing directory to \"%s\"", target.c_str())));
-            }
+            context.client->set_working_directory(*path);
         }
-        catch (liteshell::ArgumentMissingError &)
+        else
         {
-            std::cout << utils::get_working_directory() << std::endl;
+            std::cout << context.client->get_working_directory() << std::endl;
         }
 
         return 0;
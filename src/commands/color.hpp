@@ -4,17 +4,21 @@
 
 class ColorCommand : public liteshell::BaseCommand
 {
+private:
+    const liteshell::ArgumentSlot _color_slot;
+
 public:
     ColorCommand()
         : liteshell::BaseCommand(
               "color",
               "Change the text color in the shell",
               "Specify a color in hex format to change the text color",
-              liteshell::CommandConstraint("color", "The color to set", true, false)) {}
+              liteshell::CommandConstraint("color", "The color to set", true, false)),
+          _color_slot(constraint.slot("color")) {}
 
     DWORD run(const liteshell::Context &context)
     {
-        std::string color = context.get("color");
+        std::string color = context.get(_color_slot);
         utils::set_color(color);
 
         std::cout << "Color changed to " << color << std::endl;
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <all.hpp>
+
+class DecrCommand : public liteshell::BaseCommand
+{
+private:
+    const liteshell::ArgumentSlot _name_slot, _amount_slot;
+
+public:
+    DecrCommand()
+        : liteshell::BaseCommand(
+              "decr",
+              "Atomically decrease a shared counter",
+              "See \"incr\" for more information about counters.",
+              liteshell::CommandConstraint(
+                  "name", "The name of the counter", true,
+                  "amount", "The amount to subtract (default: 1)", false)),
+          _name_slot(constraint.slot("name")),
+          _amount_slot(constraint.slot("amount")) {}
+
+    DWORD run(const liteshell::Context &context)
+    {
+        const auto name = context.get(_name_slot);
+        if (!utils::is_valid_variable(name))
+        {
+            throw std::invalid_argument(utils::format("Invalid variable name \"%s\"", name.c_str()));
+        }
+
+        const auto amount = utils::parse_integer(context.value_or(_amount_slot, "1"));
+        context.client->get_environment()->get_counter(name) -= amount;
+        return 0;
+    }
+};
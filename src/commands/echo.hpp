@@ -4,17 +4,21 @@
 
 class EchoCommand : public liteshell::BaseCommand
 {
+private:
+    const liteshell::ArgumentSlot _text_slot;
+
 public:
     EchoCommand()
         : liteshell::BaseCommand(
               "echo",
               "Print to stdout but do not add a newline like \"echoln\"",
               "",
-              liteshell::CommandConstraint("text", "The text to print to stdout", true, true)) {}
+              liteshell::CommandConstraint("text", "The text to print to stdout", true, true)),
+          _text_slot(constraint.slot("text")) {}
 
     DWORD run(const liteshell::Context &context)
     {
-        auto argument = context.values.at("text");
+        auto argument = context.get_all(_text_slot);
         std::cout << utils::join(argument.begin(), argument.end(), " ") << std::flush;
         return 0;
     }
@@ -4,17 +4,21 @@
 
 class EcholnCommand : public liteshell::BaseCommand
 {
+private:
+    const liteshell::ArgumentSlot _text_slot;
+
 public:
     EcholnCommand()
         : liteshell::BaseCommand(
               "echoln",
               "Print to stdout and add a newline at the end",
               "",
-              liteshell::CommandConstraint("text", "The text to print to stdout", true, true)) {}
+              liteshell::CommandConstraint("text", "The text to print to stdout", true, true)),
+          _text_slot(constraint.slot("text")) {}
 
     DWORD run(const liteshell::Context &context)
     {
-        auto argument = context.values.at("text");
+        auto argument = context.get_all(_text_slot);
         std::cout << utils::join(argument.begin(), argument.end(), " ") << std::endl;
         return 0;
     }
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <all.hpp>
+
+class EndlocalCommand : public liteshell::BaseCommand
+{
+public:
+    EndlocalCommand()
+        : liteshell::BaseCommand(
+              "endlocal",
+              "End the innermost local scope of environment variables",
+              "All variables assigned since the matching \"setlocal\" are discarded.",
+              liteshell::CommandConstraint()) {}
+
+    DWORD run(const liteshell::Context &context)
+    {
+        context.client->get_environment()->pop_scope();
+        return 0;
+    }
+};
@@ -2,19 +2,137 @@
 
 #include <all.hpp>
 
+/** @brief The number of rows `env` uses to compute its column widths */
+#define LITE_SHELL_ENV_SAMPLE_ROWS 256
+
 class EnvCommand : public liteshell::BaseCommand
 {
+private:
+    const liteshell::ArgumentSlot _prefix_slot, _file_slot, _format_slot, _glob_pattern_slot, _names_only_slot;
+
+    /** @brief Escape a value so that it fits in a single tab-separated field */
+    static void _write_tsv_field(std::ostream &stream, const std::string_view &value)
+    {
+        for (auto c : value)
+        {
+            switch (c)
+            {
+            case '\\':
+                stream << "\\\\";
+                break;
+            case '\t':
+                stream << "\\t";
+                break;
+            case '\n':
+                stream << "\\n";
+                break;
+            case '\r':
+                stream << "\\r";
+                break;
+            default:
+                stream << c;
+            }
+        }
+    }
+
 public:
     EnvCommand()
         : liteshell::BaseCommand(
               "env",
-              "Display all environment variables",
-              "",
-              liteshell::CommandConstraint()) {}
+              "Display, save or load environment variables",
+              "Display the environment variables whose names start with <prefix> (all variables by default), sorted\n"
+              "by name. Rows are printed as they are read, with column widths computed from the first rows only.\n"
+              "Special forms (\"save\" and \"load\" are therefore not valid prefixes):\n"
+              "- env save <file>: save all variables (and their export marks) to a binary snapshot file\n"
+              "- env load <file>: load the variables of a snapshot file into the current scope",
+              liteshell::CommandConstraint(
+                  "prefix", "The prefix of the variable names to display", false,
+                  "file", "The snapshot file (for \"save\" and \"load\")", false)
+                  .add_option(
+                      "--glob",
+                      "Only display variables whose names match a wildcard pattern (\"*\" and \"?\")",
+                      liteshell::PositionalArgument("pattern", "The wildcard pattern", false, true))
+                  .add_option("--names-only", "Only display the names of the variables")
+                  .add_option(
+                      "--format",
+                      "The output format: \"table\" (default) or \"tsv\" (one escaped name<TAB>value line per variable)",
+                      liteshell::PositionalArgument("format", "The output format", false, true))),
+          _prefix_slot(constraint.slot("prefix")),
+          _file_slot(constraint.slot("file")),
+          _format_slot(constraint.slot("--format format")),
+          _glob_pattern_slot(constraint.slot("--glob pattern")),
+          _names_only_slot(constraint.slot("--names-only")) {}
 
     DWORD run(const liteshell::Context &context)
     {
-        utils::Table displayer("Name", "Value");
+        const auto environment_ptr = context.client->get_environment();
+        const auto prefix = context.value_or(_prefix_slot, "");
+        const auto file = context.get_optional(_file_slot);
+        if (!file.has_value() && (prefix == "save" || prefix == "load"))
+        {
+            throw std::invalid_argument("Missing snapshot file");
+        }
+
+        if (file.has_value())
+        {
+            if (prefix == "save")
+            {
+                environment_ptr->save_snapshot(*file);
+            }
+            else if (prefix == "load")
+            {
+                environment_ptr->load_snapshot(*file);
+            }
+            else
+            {
+                throw std::invalid_argument(utils::format("Unknown operation \"%s\"", prefix.c_str()));
+            }
+
+            return 0;
+        }
+
+        const auto format = context.value_or(_format_slot, "table");
+        if (format != "table" && format != "tsv")
+        {
+            throw std::invalid_argument(utils::format("Unknown format \"%s\"", format.c_str()));
+        }
+
+        const auto pattern = context.get_optional(_glob_pattern_slot);
+        const bool glob = pattern.has_value();
+        auto filter = [&prefix, glob, &pattern](const std::string_view &name)
+        {
+            return name.substr(0, prefix.size()) == prefix && (!glob || utils::glob_match(*pattern, name));
+        };
+
+        if (context.has(_names_only_slot))
+        {
+            environment_ptr->for_each_value(
+                filter,
+                [](const std::string_view &name, const std::string_view &)
+                {
+                    std::cout << name << '\n';
+                });
+
+            std::cout << std::flush;
+            return 0;
+        }
+
+        if (format == "tsv")
+        {
+            environment_ptr->for_each_value(
+                filter,
+                [](const std::string_view &name, const std::string_view &value)
+                {
+                    std::cout << name << '\t';
+                    _write_tsv_field(std::cout, value);
+                    std::cout << '\n';
+                });
+
+            std::cout << std::flush;
+            return 0;
+        }
+
+        utils::TableStream displayer(std::cout, {"Name", "Value"}, LITE_SHELL_ENV_SAMPLE_ROWS);
         try
         {
             // This will throw std::runtime_error when running without a console (testing with pytest for example)
@@ -26,12 +144,24 @@ public:
             // pass
         }
 
-        for (auto &[name, value] : context.client->get_environment()->get_values())
-        {
-            displayer.add_row(name, value);
-        }
+        environment_ptr->for_each_value(
+            filter,
+            [&displayer](const std::string_view &name, const std::string_view &value)
+            {
+                // Long values (e.g. file contents) are abbreviated
+                if (value.size() >= LITE_SHELL_SHARED_VALUE_SIZE)
+                {
+                    auto abbreviated = utils::format("%s... (%u bytes)", std::string(value.substr(0, 64)).c_str(), value.size());
+                    displayer.add_row({name, abbreviated});
+                }
+                else
+                {
+                    displayer.add_row({name, value});
+                }
+            });
 
-        std::cout << displayer.display() << std::endl;
+        displayer.flush();
+        std::cout << std::endl;
         return 0;
     }
 };
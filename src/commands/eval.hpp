@@ -4,27 +4,62 @@
 
 class EvalCommand : public liteshell::BaseCommand
 {
+private:
+    const liteshell::ArgumentSlot _f_slot, _m_slot, _a_slot, _a_var_slot, _s_slot, _s_var_slot, _expression_slot, _p_slot;
+
 public:
     EvalCommand()
         : liteshell::BaseCommand(
               "eval",
               "Evaluate an expression",
               "The default behavior of this command is to treat the argument as a string and print it to stdout (which is\n"
-              "similar to the \"echoln\" command. Different behavior can be achieved by using the parameters listed here.",
-              liteshell::CommandConstraint("expression", "A string expression, or a math expression if -m is specified", true)
+              "similar to the \"echoln\" command. Different behavior can be achieved by using the parameters listed here.\n\n"
+              "In a math expression, bare identifiers are read as integer variables e.g. \"eval -m \"div * div\"\".\n"
+              "With -f, numbers and variables are double-precision floating-point numbers e.g. \"eval -f \"total / 3\"\".",
+              liteshell::CommandConstraint("expression", "A string expression, or a math expression if -m or -f is specified", true)
+                  .add_option(
+                      "-a",
+                      "Append the input to an environment variable instead of printing to stdout",
+                      liteshell::PositionalArgument("var", "The variable name", false, true))
+                  .add_option("-f", "Same as -m, but evaluate with floating-point numbers instead of integers")
                   .add_option("-m", "Treat the input as a mathematical expression instead of a string and evaluate it")
                   .add_option("-p", "Print the input to stdout, read stdin and treat it as the original input")
                   .add_option(
                       "-s",
                       "Save the input to an environment variable instead of printing to stdout",
-                      liteshell::PositionalArgument("var", "The variable name", false, true)))
+                      liteshell::PositionalArgument("var", "The variable name", false, true))),
+          _f_slot(constraint.slot("-f")),
+          _m_slot(constraint.slot("-m")),
+          _a_slot(constraint.slot("-a")),
+          _a_var_slot(constraint.slot("-a var")),
+          _s_slot(constraint.slot("-s")),
+          _s_var_slot(constraint.slot("-s var")),
+          _expression_slot(constraint.slot("expression")),
+          _p_slot(constraint.slot("-p"))
     {
     }
 
     DWORD run(const liteshell::Context &context)
     {
-        auto input = context.get("expression");
-        if (context.present.count("-p"))
+        // Reject invalid option combinations before prompting or evaluating anything
+        if (context.has(_f_slot) && context.has(_m_slot))
+        {
+            throw std::invalid_argument("-f and -m cannot be used together");
+        }
+
+        if (context.has(_a_slot) && context.has(_s_slot))
+        {
+            throw std::invalid_argument("-a and -s cannot be used together");
+        }
+
+        const auto name = context.get_optional(context.has(_a_slot) ? _a_var_slot : _s_var_slot);
+        if (name.has_value() && !utils::is_valid_variable(*name))
+        {
+            throw std::invalid_argument(utils::format("Invalid variable name \"%s\"", name->c_str()));
+        }
+
+        auto input = context.get(_expression_slot);
+        if (context.has(_p_slot))
         {
             input = context.client->get_stream()->getline(
                 [&input]()
@@ -32,16 +67,26 @@ public:
                 liteshell::InputStream::FORCE_ECHO | liteshell::InputStream::FORCE_STDIN);
         }
 
-        auto result = context.present.count("-m") ? std::to_string(context.client->get_environment()->eval_ll(input)) : input;
-        if (context.present.count("-s"))
+        auto result = input;
+        if (context.has(_f_slot))
+        {
+            result = utils::real_number(context.client->get_environment()->eval_d(input));
+        }
+        else if (context.has(_m_slot))
         {
-            auto name = context.get("-s var");
-            if (!utils::is_valid_variable(name))
+            result = std::to_string(context.client->get_environment()->eval_ll(input));
+        }
+
+        if (name.has_value())
+        {
+            if (context.has(_a_slot))
             {
-                throw std::invalid_argument(utils::format("Invalid variable name \"%s\"", name.c_str()));
+                context.client->get_environment()->append_value(*name, result);
+            }
+            else
+            {
+                context.client->get_environment()->set_value(*name, result);
             }
-
-            context.client->get_environment()->set_value(name, result);
         }
         else
         {
@@ -2,28 +2,26 @@
 
 #include <all.hpp>
 
-class ExitCommand : public liteshell::BaseCommand
+struct ExitArguments
+{
+    std::optional<int> exitcode;
+};
+
+class ExitCommand : public liteshell::TypedCommand<ExitCommand, ExitArguments>
 {
 public:
+    static constexpr auto signature = liteshell::make_signature<ExitArguments>(
+        liteshell::positional("exitcode", "The code to exit with", &ExitArguments::exitcode));
+
     ExitCommand()
-        : liteshell::BaseCommand(
+        : liteshell::TypedCommand<ExitCommand, ExitArguments>(
               "exit",
               "Exit the shell with the specified exit code",
-              "If no exit code is specified, the shell will exit with the current errorlevel.",
-              liteshell::CommandConstraint("exitcode", "The code to exit with", false)) {}
+              "If no exit code is specified, the shell will exit with the current errorlevel.") {}
 
-    DWORD run(const liteshell::Context &context)
+    DWORD run(const liteshell::Context &context, const ExitArguments &arguments)
     {
-        try
-        {
-            auto code = std::stoi(context.get("exitcode"));
-            exit(code);
-        }
-        catch (liteshell::ArgumentMissingError &)
-        {
-            exit(context.client->get_errorlevel());
-        }
-
+        exit(arguments.exitcode.has_value() ? *arguments.exitcode : context.client->get_errorlevel());
         return 0;
     }
 };
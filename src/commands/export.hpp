@@ -0,0 +1,58 @@
+#pragma once
+
+#include <all.hpp>
+
+class ExportCommand : public liteshell::BaseCommand
+{
+private:
+    const liteshell::ArgumentSlot _names_slot, _n_slot;
+
+public:
+    ExportCommand()
+        : liteshell::BaseCommand(
+              "export",
+              "Mark environment variables to be passed to subprocesses",
+              "Exported variables are added to the environment of every subprocess spawned by the shell, overriding\n"
+              "inherited variables of the same name. Without any names, display all exported variables.",
+              liteshell::CommandConstraint("names", "The names of the variables to export", false, true)
+                  .add_option("-n", "Remove the export mark of the variables instead")),
+          _names_slot(constraint.slot("names")),
+          _n_slot(constraint.slot("-n")) {}
+
+    DWORD run(const liteshell::Context &context)
+    {
+        const auto environment_ptr = context.client->get_environment();
+        const auto names = context.get_all(_names_slot);
+        if (names.empty())
+        {
+            for (auto &name : environment_ptr->get_exported())
+            {
+                std::cout << name << "=" << environment_ptr->get_view(name) << std::endl;
+            }
+
+            return 0;
+        }
+
+        for (auto &name : names)
+        {
+            if (!utils::is_valid_variable(name))
+            {
+                throw std::invalid_argument(utils::format("Invalid variable name \"%s\"", name.c_str()));
+            }
+        }
+
+        for (auto &name : names)
+        {
+            if (context.has(_n_slot))
+            {
+                environment_ptr->unexport_variable(name);
+            }
+            else
+            {
+                environment_ptr->export_variable(name);
+            }
+        }
+
+        return 0;
+    }
+};
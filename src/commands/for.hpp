@@ -5,6 +5,8 @@
 class ForCommand : public liteshell::BaseCommand
 {
 private:
+    const liteshell::ArgumentSlot _var_slot, _x_slot, _y_slot;
+
     unsigned long long _label_counter = 0;
 
     std::string _make_new_label()
@@ -53,7 +55,10 @@ public:
               liteshell::CommandConstraint(
                   "var", "The name of the loop variable", true,
                   "x", "The start of the loop range", true,
-                  "y", "The end of the loop range", true))
+                  "y", "The end of the loop range", true)),
+          _var_slot(constraint.slot("var")),
+          _x_slot(constraint.slot("x")),
+          _y_slot(constraint.slot("y"))
     {
     }
 
@@ -67,8 +72,8 @@ public:
             context.constraint);
 
         const auto stream_ptr = raw_context.client->get_stream();
-        const auto loop_var = raw_context.get("var");
-        const auto start = raw_context.get("x"), end = raw_context.get("y");
+        const auto loop_var = raw_context.get(_var_slot);
+        const auto start = raw_context.get(_x_slot), end = raw_context.get(_y_slot);
 
         stream_ptr->consume_last();
         auto lines = _get_lines(raw_context);
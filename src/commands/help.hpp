@@ -4,6 +4,9 @@
 
 class HelpCommand : public liteshell::BaseCommand
 {
+private:
+    const liteshell::ArgumentSlot _command_slot;
+
 public:
     HelpCommand()
         : liteshell::BaseCommand(
@@ -11,56 +14,56 @@ public:
               "Get all commands or get help for a specific command",
               "Provides help information about shell commands.\n"
               "To get help for a specific command, specify its name as the first argument (e.g. \"help help\").",
-              liteshell::CommandConstraint("command", "The command to get help for", false))
+              liteshell::CommandConstraint("command", "The command to get help for", false)),
+          _command_slot(constraint.slot("command"))
     {
     }
 
     DWORD run(const liteshell::Context &context)
     {
-        try
+        auto name = context.get_optional(_command_slot);
+        if (name.has_value())
         {
-            auto name = context.get("command");
-            auto wrapper = context.client->get_optional_command(name);
+            auto wrapper = context.client->get_optional_command(*name);
             if (wrapper.has_value())
             {
                 std::cout << (*wrapper)->help();
             }
             else
             {
-                auto error = liteshell::CommandNotFound(name, context.client->fuzzy_command_search(name).c_str());
-                throw std::invalid_argument(error.message);
+                throw std::invalid_argument(liteshell::CommandNotFound::format(*name, context.client->fuzzy_command_search(*name)));
             }
+
+            return 0;
         }
-        catch (liteshell::ArgumentMissingError &)
+
+        auto commands = context.client->walk_commands();
+        for (auto iter = commands.begin(); iter != commands.end();)
         {
-            auto commands = context.client->walk_commands();
-            for (auto iter = commands.begin(); iter != commands.end();)
+            if ((*iter)->name[0] == '_') // hidden command
             {
-                if ((*iter)->name[0] == '_') // hidden command
-                {
-                    iter = commands.erase(iter);
-                }
-                else
-                {
-                    iter++;
-                }
+                iter = commands.erase(iter);
             }
-
-            std::size_t max_width = 0;
-            for (auto &wrapper : commands)
+            else
             {
-                max_width = std::max(max_width, 3 + wrapper->name.size());
+                iter++;
             }
+        }
 
-            for (auto &wrapper : commands)
+        std::size_t max_width = 0;
+        for (auto &wrapper : commands)
+        {
+            max_width = std::max(max_width, 3 + wrapper->name.size());
+        }
+
+        for (auto &wrapper : commands)
+        {
+            std::cout << wrapper->name;
+            for (auto i = wrapper->name.size(); i < max_width; i++)
             {
-                std::cout << wrapper->name;
-                for (auto i = wrapper->name.size(); i < max_width; i++)
-                {
-                    std::cout << " ";
-                }
-                std::cout << wrapper->description << std::endl;
+                std::cout << " ";
             }
+            std::cout << wrapper->description << std::endl;
         }
 
         return 0;
@@ -5,6 +5,8 @@
 class IfCommand : public liteshell::BaseCommand
 {
 private:
+    const liteshell::ArgumentSlot _x_slot, _f_slot, _m_slot, _operator_slot, _y_slot;
+
     unsigned long long _label_counter = 0;
 
     std::string _make_new_label()
@@ -19,13 +21,23 @@ public:
               "Compare strings or math expressions",
               "<operator> must be one of the values: \"==\", \"!=\", \"<\", \">\", \"<=\", \">=\".\n\n"
               "The strings are compared using the lexicography order.\n"
-              "If the flag -m is set, perform mathematical evaluation before making algebra comparisons.\n"
+              "If the flag -m is set, perform mathematical evaluation before making algebra comparisons. Bare identifiers\n"
+              "in math expressions are read as integer variables e.g. \"if -m \"div * div\" > n\".\n"
+              "If the flag -f is set, do the same with floating-point numbers.\n"
+              "With -m or -f, <operator> and <y> may be omitted to test a single expression, which is true if it is non-zero\n"
+              "e.g. \"if -m \"n > 0 && n % 2 == 0\"\".\n"
               "To end each condition section, use \"else\"/\"endif\".",
               liteshell::CommandConstraint(
                   "x", "The first value to compare", true,
-                  "operator", "The operator to use for comparison", true,
-                  "y", "The second value to compare", true)
-                  .add_option("-m", "Perform mathematical comparison instead of string comparison", false))
+                  "operator", "The operator to use for comparison", false,
+                  "y", "The second value to compare", false)
+                  .add_option("-f", "Same as -m, but evaluate with floating-point numbers instead of integers", false)
+                  .add_option("-m", "Perform mathematical comparison instead of string comparison", false)),
+          _x_slot(constraint.slot("x")),
+          _f_slot(constraint.slot("-f")),
+          _m_slot(constraint.slot("-m")),
+          _operator_slot(constraint.slot("operator")),
+          _y_slot(constraint.slot("y"))
     {
     }
 
@@ -37,6 +49,16 @@ public:
             context.original_message,
             context.original_message,
             context.constraint);
+
+        // A single math expression is tested against 0
+        std::string x = raw_context.get(_x_slot), op = "!=", y = "0";
+        const auto mode = raw_context.has(_f_slot) ? "-f" : (raw_context.has(_m_slot) ? "-m" : "");
+        if (raw_context.has(_operator_slot) || mode[0] == '\0')
+        {
+            op = raw_context.get(_operator_slot);
+            y = raw_context.get(_y_slot);
+        }
+
         const auto stream_ptr = raw_context.client->get_stream();
         bool force_stream = !stream_ptr->exhaust();
 
@@ -131,11 +153,10 @@ public:
         stream_ptr->write(if_false.begin(), if_false.end());
         stream_ptr->write(if_true.begin(), if_true.end());
 
-        auto x = raw_context.get("x"), op = raw_context.get("operator"), y = raw_context.get("y");
         stream_ptr->write(
             utils::format(
                 "_if %s \"%s\" \"%s\" \"%s\" \"%s\" \"%s\"",
-                raw_context.present.count("-m") ? "-m" : "",
+                mode,
                 x.c_str(), op.c_str(), y.c_str(),
                 true_label.c_str(), false_label.c_str()));
         stream_ptr->write(liteshell::InputStream::ECHO_OFF);
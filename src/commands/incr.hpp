@@ -0,0 +1,36 @@
+#pragma once
+
+#include <all.hpp>
+
+class IncrCommand : public liteshell::BaseCommand
+{
+private:
+    const liteshell::ArgumentSlot _name_slot, _amount_slot;
+
+public:
+    IncrCommand()
+        : liteshell::BaseCommand(
+              "incr",
+              "Atomically increase a shared counter",
+              "A counter starts at 0 and is read like a variable (e.g. $failures), unless a variable of the same name\n"
+              "is assigned. Counters can be updated safely from multiple threads of the shell. Background jobs run in\n"
+              "separate processes and cannot see them.",
+              liteshell::CommandConstraint(
+                  "name", "The name of the counter", true,
+                  "amount", "The amount to add (default: 1)", false)),
+          _name_slot(constraint.slot("name")),
+          _amount_slot(constraint.slot("amount")) {}
+
+    DWORD run(const liteshell::Context &context)
+    {
+        const auto name = context.get(_name_slot);
+        if (!utils::is_valid_variable(name))
+        {
+            throw std::invalid_argument(utils::format("Invalid variable name \"%s\"", name.c_str()));
+        }
+
+        const auto amount = utils::parse_integer(context.value_or(_amount_slot, "1"));
+        context.client->get_environment()->get_counter(name) += amount;
+        return 0;
+    }
+};
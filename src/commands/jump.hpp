@@ -4,6 +4,9 @@
 
 class JumpCommand : public liteshell::BaseCommand
 {
+private:
+    const liteshell::ArgumentSlot _label_slot;
+
 public:
     JumpCommand()
         : liteshell::BaseCommand(
@@ -11,13 +14,14 @@ public:
               "Skip the input stream to the specified label",
               "Examples: \"jump end\", \"jump :end\".\n"
               "When reading from batch scripts, a label :EOF will automatically be added to the end.",
-              liteshell::CommandConstraint("label", "The label to jump to", true))
+              liteshell::CommandConstraint("label", "The label to jump to", true)),
+          _label_slot(constraint.slot("label"))
     {
     }
 
     DWORD run(const liteshell::Context &context)
     {
-        auto label = context.get("label");
+        auto label = context.get(_label_slot);
         if (label[0] != ':')
         {
             label = ':' + label;
@@ -2,32 +2,29 @@
 
 #include <all.hpp>
 
-class KillCommand : public liteshell::BaseCommand
+struct KillArguments
+{
+    DWORD pid;
+    std::optional<UINT> exit_code;
+};
+
+class KillCommand : public liteshell::TypedCommand<KillCommand, KillArguments>
 {
 public:
+    static constexpr auto signature = liteshell::make_signature<KillArguments>(
+        liteshell::positional("pid", "The PID of the subprocess to kill", &KillArguments::pid),
+        liteshell::positional("exit_code", "The exit code to use when killing the subprocess (default: 1)", &KillArguments::exit_code));
+
     KillCommand()
-        : liteshell::BaseCommand(
+        : liteshell::TypedCommand<KillCommand, KillArguments>(
               "kill",
               "Kill a subprocess with the given PID and exit code ",
-              "",
-              liteshell::CommandConstraint(
-                  "pid", "The PID of the subprocess to kill", true,
-                  "exit_code", "The exit code to use when killing the subprocess (default: 1)", false)) {}
+              "") {}
 
-    DWORD run(const liteshell::Context &context)
+    DWORD run(const liteshell::Context &context, const KillArguments &arguments)
     {
-        DWORD pid = std::stoul(context.get("pid"));
-        UINT exit_code = 1;
-
-        try
-        {
-            exit_code = std::stoul(context.get("exit_code"));
-        }
-        catch (liteshell::ArgumentMissingError &)
-        {
-            // pass
-        }
-
+        const auto pid = arguments.pid;
+        const auto exit_code = arguments.exit_code.value_or(1);
         for (auto wrapper_ptr : context.client->get_subprocesses())
         {
             if (wrapper_ptr->pid() == pid)
@@ -4,6 +4,9 @@
 
 class LsCommand : public liteshell::BaseCommand
 {
+private:
+    const liteshell::ArgumentSlot _dir_slot;
+
 public:
     LsCommand()
         : liteshell::BaseCommand(
@@ -11,25 +14,22 @@ public:
               "Display the content of a directory",
               "",
               {"dir"},
-              liteshell::CommandConstraint("dir", "The directory to explore (default: the working directory)", false)) {}
+              liteshell::CommandConstraint("dir", "The directory to explore (default: the working directory)", false)),
+          _dir_slot(constraint.slot("dir")) {}
 
     DWORD run(const liteshell::Context &context)
     {
-        auto directory = utils::get_working_directory();
-        try
-        {
-            directory = context.get("dir");
-        }
-        catch (liteshell::ArgumentMissingError &)
+        auto directory = context.get_optional(_dir_slot);
+        if (!directory.has_value())
         {
-            // pass
+            directory = context.client->get_working_directory();
         }
 
-        std::cout << "Exploring " << directory << std::endl;
+        std::cout << "Exploring " << *directory << std::endl;
 
         utils::Table displayer("Name", "Type", "Size");
 
-        for (const auto &data : utils::list_files(utils::join(directory, "*")))
+        for (const auto &data : utils::list_files(utils::join(*directory, "*")))
         {
             long double size = ((long double)data.nFileSizeHigh * ((long double)MAXDWORD + 1.0L)) + (long double)data.nFileSizeLow;
             bool is_directory = data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY;
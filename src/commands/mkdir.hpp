@@ -2,20 +2,27 @@
 
 #include <all.hpp>
 
-class MkdirCommand : public liteshell::BaseCommand
+struct MkdirArguments
+{
+    liteshell::Path dir;
+};
+
+class MkdirCommand : public liteshell::TypedCommand<MkdirCommand, MkdirArguments>
 {
 public:
+    static constexpr auto signature = liteshell::make_signature<MkdirArguments>(
+        liteshell::positional("dir", "The name of the new directory", &MkdirArguments::dir));
+
     MkdirCommand()
-        : liteshell::BaseCommand(
+        : liteshell::TypedCommand<MkdirCommand, MkdirArguments>(
               "mkdir",
               "Make a new directory",
               "",
-              {"md"},
-              liteshell::CommandConstraint("dir", "The name of the new directory", true)) {}
+              {"md"}) {}
 
-    DWORD run(const liteshell::Context &context)
+    DWORD run(const liteshell::Context &, const MkdirArguments &arguments)
     {
-        if (!CreateDirectoryW(utils::utf_convert(context.get("dir")).c_str(), NULL))
+        if (!CreateDirectoryW(utils::utf_convert(arguments.dir.value).c_str(), NULL))
         {
             throw std::runtime_error(utils::last_error("Unable to create directory"));
         }
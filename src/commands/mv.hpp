@@ -4,6 +4,9 @@
 
 class MvCommand : public liteshell::BaseCommand
 {
+private:
+    const liteshell::ArgumentSlot _old_slot, _new_slot;
+
 public:
     MvCommand()
         : liteshell::BaseCommand(
@@ -12,12 +15,14 @@ public:
               "",
               liteshell::CommandConstraint(
                   "old", "The existing file/directory name", true,
-                  "new", "The new file/directory name", true)) {}
+                  "new", "The new file/directory name", true)),
+          _old_slot(constraint.slot("old")),
+          _new_slot(constraint.slot("new")) {}
 
     DWORD run(const liteshell::Context &context)
     {
-        auto old_path = context.get("old");
-        auto new_path = context.get("new");
+        auto old_path = context.get(_old_slot);
+        auto new_path = context.get(_new_slot);
         if (!MoveFileW(utils::utf_convert(old_path).c_str(), utils::utf_convert(new_path).c_str()))
         {
             throw std::runtime_error(utils::last_error("MoveFileW ERROR"));
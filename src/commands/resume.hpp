@@ -2,19 +2,26 @@
 
 #include <all.hpp>
 
-class ResumeCommand : public liteshell::BaseCommand
+struct ResumeArguments
+{
+    DWORD pid;
+};
+
+class ResumeCommand : public liteshell::TypedCommand<ResumeCommand, ResumeArguments>
 {
 public:
+    static constexpr auto signature = liteshell::make_signature<ResumeArguments>(
+        liteshell::positional("pid", "The PID of the target process", &ResumeArguments::pid));
+
     ResumeCommand()
-        : liteshell::BaseCommand(
+        : liteshell::TypedCommand<ResumeCommand, ResumeArguments>(
               "resume",
               "Resume a suspended subprocess with the given PID",
-              "",
-              liteshell::CommandConstraint("pid", "The PID of the target process", true)) {}
+              "") {}
 
-    DWORD run(const liteshell::Context &context)
+    DWORD run(const liteshell::Context &context, const ResumeArguments &arguments)
     {
-        DWORD pid = std::stoul(context.get("pid"));
+        const auto pid = arguments.pid;
         for (auto wrapper_ptr : context.client->get_subprocesses())
         {
             if (wrapper_ptr->pid() == pid)
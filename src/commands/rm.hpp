@@ -4,17 +4,21 @@
 
 class RmCommand : public liteshell::BaseCommand
 {
+private:
+    const liteshell::ArgumentSlot _targets_slot;
+
 public:
     RmCommand()
         : liteshell::BaseCommand(
               "rm",
               "Remove one or many files/directories",
               "If any of the targets is a directory, remove it recursively",
-              liteshell::CommandConstraint("targets", "The targets to remove", true, true)) {}
+              liteshell::CommandConstraint("targets", "The targets to remove", true, true)),
+          _targets_slot(constraint.slot("targets")) {}
 
     DWORD run(const liteshell::Context &context)
     {
-        for (auto &target : context.values.at("targets"))
+        for (auto &target : context.get_all(_targets_slot))
         {
             auto targets = utils::list_files(target);
             if (targets.empty())
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <all.hpp>
+
+class SetlocalCommand : public liteshell::BaseCommand
+{
+public:
+    SetlocalCommand()
+        : liteshell::BaseCommand(
+              "setlocal",
+              "Begin a local scope of environment variables",
+              "Variables assigned after this command are discarded by the matching \"endlocal\", while variables of\n"
+              "the enclosing scopes remain visible. Local scopes that are still open at the end of a batch script\n"
+              "are closed automatically.",
+              liteshell::CommandConstraint()) {}
+
+    DWORD run(const liteshell::Context &context)
+    {
+        context.client->get_environment()->push_scope();
+        return 0;
+    }
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <all.hpp>
+
+class ShareCommand : public liteshell::BaseCommand
+{
+private:
+    const liteshell::ArgumentSlot _name_slot, _value_slot;
+
+public:
+    ShareCommand()
+        : liteshell::BaseCommand(
+              "share",
+              "Set the value of a shared variable",
+              "A shared value is read like a variable (e.g. $status), unless a variable or a counter of the same name\n"
+              "exists. Like counters, shared values can be updated safely from multiple threads of the shell.\n"
+              "Background jobs run in separate processes and cannot see them.",
+              liteshell::CommandConstraint(
+                  "name", "The name of the shared value", true,
+                  "value", "The new value", true)),
+          _name_slot(constraint.slot("name")),
+          _value_slot(constraint.slot("value")) {}
+
+    DWORD run(const liteshell::Context &context)
+    {
+        const auto name = context.get(_name_slot);
+        if (!utils::is_valid_variable(name))
+        {
+            throw std::invalid_argument(utils::format("Invalid variable name \"%s\"", name.c_str()));
+        }
+
+        context.client->get_environment()->set_shared_value(name, context.get(_value_slot));
+        return 0;
+    }
+};
@@ -4,17 +4,21 @@
 
 class StartCommand : public liteshell::BaseCommand
 {
+private:
+    const liteshell::ArgumentSlot _command_slot;
+
 public:
     StartCommand()
         : liteshell::BaseCommand(
               "start",
               "Starts a new window of the command shell, run the specified command and exit.",
               "",
-              liteshell::CommandConstraint("command", "The command line to run", true)) {}
+              liteshell::CommandConstraint("command", "The command line to run", true)),
+          _command_slot(constraint.slot("command")) {}
 
     DWORD run(const liteshell::Context &context)
     {
-        auto command = context.get("command");
+        auto command = context.get(_command_slot);
         context.client->spawn_subprocess(
             utils::format("%s \"%s\"", utils::get_executable_path().c_str(), command.c_str()),
             true, // no effect
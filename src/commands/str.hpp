@@ -0,0 +1,246 @@
+#pragma once
+
+#include <all.hpp>
+
+class StrCommand : public liteshell::BaseCommand
+{
+private:
+    const liteshell::ArgumentSlot _operation_slot, _operands_slot, _r_slot, _s_slot, _s_var_slot;
+
+    static void _expect_operands(const std::string &operation, const liteshell::ArgumentValues &operands, const std::size_t min, const std::size_t max)
+    {
+        if (operands.size() < min || operands.size() > max)
+        {
+            throw std::invalid_argument(
+                min == max
+                    ? utils::format("\"%s\" expects %u operand(s), got %u", operation.c_str(), min, operands.size())
+                    : utils::format("\"%s\" expects %u to %u operands, got %u", operation.c_str(), min, max, operands.size()));
+        }
+    }
+
+    static std::string _replace(const std::string_view &text, const std::string_view &old_value, const std::string_view &new_value)
+    {
+        if (old_value.empty())
+        {
+            throw std::invalid_argument("Cannot replace an empty string");
+        }
+
+        std::string result;
+        result.reserve(text.size());
+
+        std::size_t start = 0, position;
+        while ((position = text.find(old_value, start)) != std::string_view::npos)
+        {
+            result.append(text, start, position - start);
+            result.append(new_value);
+            start = position + old_value.size();
+        }
+
+        result.append(text, start);
+        return result;
+    }
+
+public:
+    StrCommand()
+        : liteshell::BaseCommand(
+              "str",
+              "Perform string operations",
+              "Supported operations:\n"
+              "- len <text>: the length of <text> in bytes\n"
+              "- sub <text> <start> [length]: the substring starting at <start> (negative values count from the end)\n"
+              "- find <text> <pattern>: the position of the first occurrence of <pattern>, or -1\n"
+              "- replace <text> <old> <new>: replace all occurrences of <old> with <new>\n"
+              "- split <text> <delimiter>: split <text> into an array (see \"array\")\n"
+              "- join <arr> <delimiter>: join the elements of an array\n"
+              "- append <var> <text>: append <text> to the variable <var> in place\n"
+              "- upper <text>, lower <text>, trim <text>: change case, or remove surrounding whitespaces\n"
+              "With -r, <pattern>, <old> and <delimiter> are regular expressions and <new> may refer to groups with \"$$1\".\n"
+              "The result is printed to stdout, or saved to the variable (or array) specified with -s.",
+              liteshell::CommandConstraint(
+                  "operation", "The operation to perform", true,
+                  "operands", "The operands of the operation", true, true)
+                  .add_option("-r", "Treat patterns as regular expressions")
+                  .add_option(
+                      "-s",
+                      "Save the result to this variable (or array) instead of printing to stdout",
+                      liteshell::PositionalArgument("var", "The variable name", false, true))),
+          _operation_slot(constraint.slot("operation")),
+          _operands_slot(constraint.slot("operands")),
+          _r_slot(constraint.slot("-r")),
+          _s_slot(constraint.slot("-s")),
+          _s_var_slot(constraint.slot("-s var"))
+    {
+    }
+
+    DWORD run(const liteshell::Context &context)
+    {
+        const auto operation = context.get(_operation_slot);
+        const auto &operands = context.get_all(_operands_slot);
+        const auto environment_ptr = context.client->get_environment();
+        const bool regex = context.has(_r_slot);
+
+        std::optional<std::string> target;
+        if (context.has(_s_slot))
+        {
+            target = context.get(_s_var_slot);
+            if (!utils::is_valid_variable(*target))
+            {
+                throw std::invalid_argument(utils::format("Invalid variable name \"%s\"", target->c_str()));
+            }
+        }
+
+        const std::string_view text = operands[0];
+        std::string result;
+        if (operation == "append")
+        {
+            _expect_operands(operation, operands, 2, 2);
+            if (!utils::is_valid_variable(operands[0]))
+            {
+                throw std::invalid_argument(utils::format("Invalid variable name \"%s\"", operands[0].c_str()));
+            }
+
+            environment_ptr->append_value(operands[0], operands[1]);
+            return 0;
+        }
+        else if (operation == "len")
+        {
+            _expect_operands(operation, operands, 1, 1);
+            result = std::to_string(text.size());
+        }
+        else if (operation == "sub")
+        {
+            _expect_operands(operation, operands, 2, 3);
+            auto start = utils::parse_integer(operands[1]);
+            if (start < 0)
+            {
+                start = std::max<long long>(start + text.size(), 0);
+            }
+
+            auto length = operands.size() == 3 ? utils::parse_integer(operands[2]) : (long long)text.size();
+            if (length < 0)
+            {
+                throw std::invalid_argument("Length must not be negative");
+            }
+
+            result = text.substr(std::min<std::size_t>(start, text.size()), length);
+        }
+        else if (operation == "find")
+        {
+            _expect_operands(operation, operands, 2, 2);
+            long long position = -1;
+            if (regex)
+            {
+                boost::match_results<std::string_view::const_iterator> match;
+                if (boost::regex_search(text.begin(), text.end(), match, boost::regex(operands[1])))
+                {
+                    position = match.position();
+                }
+            }
+            else
+            {
+                auto found = text.find(operands[1]);
+                position = found == std::string_view::npos ? -1 : found;
+            }
+
+            result = std::to_string(position);
+        }
+        else if (operation == "replace")
+        {
+            _expect_operands(operation, operands, 3, 3);
+            result = regex
+                         ? boost::regex_replace(operands[0], boost::regex(operands[1]), operands[2])
+                         : _replace(text, operands[1], operands[2]);
+        }
+        else if (operation == "split")
+        {
+            _expect_operands(operation, operands, 2, 2);
+
+            // Tokens are views into the original text, the array is written without intermediate copies
+            std::vector<std::string_view> tokens;
+            if (regex)
+            {
+                const boost::regex delimiter(operands[1]);
+                boost::match_results<std::string_view::const_iterator> match;
+                auto start = text.begin();
+                while (start != text.end() && boost::regex_search(start, text.end(), match, delimiter) && match.length() > 0)
+                {
+                    tokens.emplace_back(&*start, match[0].first - start);
+                    start = match[0].second;
+                }
+
+                tokens.emplace_back(start == text.end() ? std::string_view() : std::string_view(&*start, text.end() - start));
+            }
+            else
+            {
+                const std::string_view delimiter = operands[1];
+                if (delimiter.empty())
+                {
+                    throw std::invalid_argument("Delimiter must not be empty");
+                }
+
+                std::size_t start = 0, position;
+                while ((position = text.find(delimiter, start)) != std::string_view::npos)
+                {
+                    tokens.push_back(text.substr(start, position - start));
+                    start = position + delimiter.size();
+                }
+
+                tokens.push_back(text.substr(start));
+            }
+
+            if (target.has_value())
+            {
+                environment_ptr->set_array(*target, tokens);
+            }
+            else
+            {
+                for (auto &token : tokens)
+                {
+                    std::cout << token << std::endl;
+                }
+            }
+
+            return 0;
+        }
+        else if (operation == "join")
+        {
+            _expect_operands(operation, operands, 2, 2);
+            auto elements = environment_ptr->get_array(operands[0]);
+            result = utils::join(elements.begin(), elements.end(), operands[1]);
+        }
+        else if (operation == "upper" || operation == "lower")
+        {
+            _expect_operands(operation, operands, 1, 1);
+            result = text;
+            if (operation == "upper")
+            {
+                std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+            }
+            else
+            {
+                std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            }
+        }
+        else if (operation == "trim")
+        {
+            _expect_operands(operation, operands, 1, 1);
+            auto begin = text.find_first_not_of(" \t\r\n");
+            result = begin == std::string_view::npos ? "" : text.substr(begin, text.find_last_not_of(" \t\r\n") - begin + 1);
+        }
+        else
+        {
+            throw std::invalid_argument(utils::format("Unknown operation \"%s\"", operation.c_str()));
+        }
+
+        if (target.has_value())
+        {
+            environment_ptr->set_value(*target, result);
+        }
+        else
+        {
+            std::cout << result << std::endl;
+        }
+
+        return 0;
+    }
+};
@@ -2,19 +2,26 @@
 
 #include <all.hpp>
 
-class SuspendCommand : public liteshell::BaseCommand
+struct SuspendArguments
+{
+    DWORD pid;
+};
+
+class SuspendCommand : public liteshell::TypedCommand<SuspendCommand, SuspendArguments>
 {
 public:
+    static constexpr auto signature = liteshell::make_signature<SuspendArguments>(
+        liteshell::positional("pid", "The PID of the target process", &SuspendArguments::pid));
+
     SuspendCommand()
-        : liteshell::BaseCommand(
+        : liteshell::TypedCommand<SuspendCommand, SuspendArguments>(
               "suspend",
               "Suspend a subprocess with the given PID",
-              "",
-              liteshell::CommandConstraint("pid", "The PID of the target process", true)) {}
+              "") {}
 
-    DWORD run(const liteshell::Context &context)
+    DWORD run(const liteshell::Context &context, const SuspendArguments &arguments)
     {
-        DWORD pid = std::stoul(context.get("pid"));
+        const auto pid = arguments.pid;
         for (auto wrapper_ptr : context.client->get_subprocesses())
         {
             if (wrapper_ptr->pid() == pid)
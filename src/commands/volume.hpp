@@ -4,6 +4,9 @@
 
 class VolumeCommand : public liteshell::BaseCommand
 {
+private:
+    const liteshell::ArgumentSlot _root_slot;
+
 public:
     VolumeCommand()
         : liteshell::BaseCommand(
@@ -13,11 +16,12 @@ public:
               liteshell::CommandConstraint(
                   "root",
                   "The root directory of the volume to be described, a trailing backslash is required. (e.g. \"C:\\\")",
-                  true)) {}
+                  true)),
+          _root_slot(constraint.slot("root")) {}
 
     DWORD run(const liteshell::Context &context)
     {
-        auto root = utils::utf_convert(context.get("root"));
+        auto root = utils::utf_convert(context.get(_root_slot));
 
         WCHAR volume_name[MAX_PATH], volume_fs_name[MAX_PATH];
         DWORD volume_serial_number, volume_max_component_length, volume_fs_flags;
@@ -0,0 +1,13 @@
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        auto value = std::getenv(argv[i]);
+        std::cout << argv[i] << "=" << (value == NULL ? "" : value) << std::endl;
+    }
+
+    return 0;
+}
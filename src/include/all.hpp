@@ -1,22 +1,33 @@
 #pragma once
 
+#include "arena.hpp"
+#include "array_ops.hpp"
 #include "base.hpp"
 #include "client.hpp"
+#include "command_cache.hpp"
 #include "constraint.hpp"
 #include "context.hpp"
 #include "converter.hpp"
 #include "environment.hpp"
 #include "error.hpp"
+#include "export.hpp"
+#include "expression.hpp"
 #include "finalize.hpp"
+#include "flat_map.hpp"
 #include "format.hpp"
 #include "fuzzy_search.hpp"
 #include "join.hpp"
 #include "maps.hpp"
+#include "perfect_hash.hpp"
 #include "random.hpp"
+#include "shared_string.hpp"
+#include "signature.hpp"
+#include "snapshot.hpp"
 #include "split.hpp"
 #include "standard.hpp"
 #include "stream.hpp"
 #include "strip.hpp"
+#include "striped_map.hpp"
 #include "style.hpp"
 #include "subprocess.hpp"
 #include "tables.hpp"
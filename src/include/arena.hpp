@@ -0,0 +1,56 @@
+#pragma once
+
+#include "standard.hpp"
+
+namespace utils
+{
+    /**
+     * @brief A monotonic memory resource for short-lived temporaries, backed by an inline buffer
+     *
+     * Allocations are served from the buffer (then from the default resource once it is exhausted) and are never
+     * freed individually: everything is released at once when the arena is destroyed. Declare one on the stack
+     * for the duration of an operation.
+     *
+     * @tparam N The size of the inline buffer in bytes
+     */
+    template <std::size_t N>
+    class Arena : public std::pmr::memory_resource
+    {
+    private:
+        alignas(std::max_align_t) std::byte _buffer[N];
+        std::pmr::monotonic_buffer_resource _resource;
+        std::size_t _allocations = 0, _bytes = 0;
+
+    protected:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            _allocations++;
+            _bytes += bytes;
+            return _resource.allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *, std::size_t, std::size_t) override {}
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+
+    public:
+        Arena() : _resource(_buffer, N) {}
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        /** @brief The number of allocations served by this arena */
+        std::size_t allocations() const
+        {
+            return _allocations;
+        }
+
+        /** @brief The total number of bytes allocated from this arena */
+        std::size_t bytes() const
+        {
+            return _bytes;
+        }
+    };
+}
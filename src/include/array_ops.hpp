@@ -0,0 +1,160 @@
+#pragma once
+
+#include "format.hpp"
+
+namespace utils
+{
+    /*
+     * Kernels over contiguous integer arrays. They are plain loops without dependencies between iterations
+     * (except `array_prefix_sum`), which the compiler vectorizes at -O3.
+     */
+
+    /** @brief The sum of all elements, wrapping around on overflow */
+    long long array_sum(const std::vector<long long> &values)
+    {
+        unsigned long long result = 0;
+        for (std::size_t i = 0; i < values.size(); i++)
+        {
+            result += values[i];
+        }
+
+        return result;
+    }
+
+    /** @brief The smallest element of a non-empty array */
+    long long array_min(const std::vector<long long> &values)
+    {
+        if (values.empty())
+        {
+            throw std::runtime_error("Cannot find the minimum of an empty array");
+        }
+
+        long long result = values[0];
+        for (std::size_t i = 1; i < values.size(); i++)
+        {
+            result = std::min(result, values[i]);
+        }
+
+        return result;
+    }
+
+    /** @brief The largest element of a non-empty array */
+    long long array_max(const std::vector<long long> &values)
+    {
+        if (values.empty())
+        {
+            throw std::runtime_error("Cannot find the maximum of an empty array");
+        }
+
+        long long result = values[0];
+        for (std::size_t i = 1; i < values.size(); i++)
+        {
+            result = std::max(result, values[i]);
+        }
+
+        return result;
+    }
+
+    /** @brief The dot product of 2 arrays of the same size, wrapping around on overflow */
+    long long array_dot(const std::vector<long long> &first, const std::vector<long long> &second)
+    {
+        if (first.size() != second.size())
+        {
+            throw std::runtime_error(format("Array sizes do not match: %u and %u", first.size(), second.size()));
+        }
+
+        unsigned long long result = 0;
+        for (std::size_t i = 0; i < first.size(); i++)
+        {
+            result += (unsigned long long)first[i] * (unsigned long long)second[i];
+        }
+
+        return result;
+    }
+
+    /** @brief Add the elements of `other` to `values` element-wise */
+    void array_add(std::vector<long long> &values, const std::vector<long long> &other)
+    {
+        if (values.size() != other.size())
+        {
+            throw std::runtime_error(format("Array sizes do not match: %u and %u", values.size(), other.size()));
+        }
+
+        for (std::size_t i = 0; i < values.size(); i++)
+        {
+            values[i] = (unsigned long long)values[i] + (unsigned long long)other[i];
+        }
+    }
+
+    /** @brief Multiply the elements of `values` with those of `other` element-wise */
+    void array_multiply(std::vector<long long> &values, const std::vector<long long> &other)
+    {
+        if (values.size() != other.size())
+        {
+            throw std::runtime_error(format("Array sizes do not match: %u and %u", values.size(), other.size()));
+        }
+
+        for (std::size_t i = 0; i < values.size(); i++)
+        {
+            values[i] = (unsigned long long)values[i] * (unsigned long long)other[i];
+        }
+    }
+
+    /** @brief Multiply all elements with a factor */
+    void array_scale(std::vector<long long> &values, const long long factor)
+    {
+        for (std::size_t i = 0; i < values.size(); i++)
+        {
+            values[i] = (unsigned long long)values[i] * (unsigned long long)factor;
+        }
+    }
+
+    /** @brief Replace each element with the sum of all elements up to and including it */
+    void array_prefix_sum(std::vector<long long> &values)
+    {
+        for (std::size_t i = 1; i < values.size(); i++)
+        {
+            values[i] = (unsigned long long)values[i] + (unsigned long long)values[i - 1];
+        }
+    }
+
+    /**
+     * @brief Count the elements falling into equal-width bins between the smallest and the largest element
+     *
+     * Bin `i` covers `[min + i * width, min + (i + 1) * width)` where `width = (max - min) / bins + 1`.
+     *
+     * @param values The elements to count
+     * @param bins The number of bins
+     * @return The number of elements in each bin
+     */
+    std::vector<long long> array_histogram(const std::vector<long long> &values, const std::size_t bins)
+    {
+        if (bins == 0)
+        {
+            throw std::runtime_error("The number of bins must be positive");
+        }
+
+        std::vector<long long> result(bins);
+        if (values.empty())
+        {
+            return result;
+        }
+
+        const unsigned long long low = array_min(values);
+        const unsigned long long step = ((unsigned long long)array_max(values) - low) / bins;
+        if (step == ULLONG_MAX)
+        {
+            // Only when a single bin spans the whole range of long long: "step + 1" would wrap to 0
+            result[0] = values.size();
+            return result;
+        }
+
+        const unsigned long long width = step + 1;
+        for (std::size_t i = 0; i < values.size(); i++)
+        {
+            result[((unsigned long long)values[i] - low) / width]++;
+        }
+
+        return result;
+    }
+}
@@ -1,10 +1,13 @@
 #pragma once
 
 #include "base.hpp"
+#include "command_cache.hpp"
 #include "environment.hpp"
 #include "finalize.hpp"
 #include "fuzzy_search.hpp"
 #include "maps.hpp"
+#include "perfect_hash.hpp"
+#include "random.hpp"
 #include "stream.hpp"
 #include "style.hpp"
 #include "subprocess.hpp"
@@ -12,6 +15,9 @@
 #define LITE_SHELL_SCRIPT_EXTENSION ".ff"
 #define LITE_SHELL_BUFFER_SIZE 4096
 
+/** @brief The size of the arena holding the temporaries of a `Client::process_command` call */
+#define LITE_SHELL_COMMAND_ARENA_SIZE 2048
+
 namespace liteshell
 {
     /**
@@ -33,148 +39,35 @@ namespace liteshell
         std::vector<std::shared_ptr<BaseCommand>> _wrappers;
         utils::CaseInsensitiveMap<std::size_t> _commands;
 
-        const std::unique_ptr<Environment> _environment;
-        const std::unique_ptr<InputStream> _stream;
-
-        std::shared_ptr<BaseCommand> _get_command(const std::string &name) const
-        {
-            auto iter = _commands.find(name);
-            if (iter == _commands.end())
-            {
-                throw CommandNotFound(name, fuzzy_command_search(name).c_str());
-            }
-
-            return _wrappers[iter->second];
-        }
-
-        std::shared_ptr<BaseCommand> _get_command(const Context &context) const
-        {
-            if (context.tokens.empty())
-            {
-                throw std::invalid_argument("No command provided");
-            }
-
-            return _get_command(context.tokens[0]);
-        }
-
-        /**
-         * @brief Find an executable that `token` points to.
-         *
-         * The function will first look in the current working directory, then in the directories specified in `resolve_order`.
-         *
-         * @see https://stackoverflow.com/a/605139
-         * @param token The token to resolve. This token may be a relative or absolute path.
-         * @return The path to the executable if found, `std::nullopt` otherwise.
-         */
-        std::optional<std::string> resolve(const std::string &token) const
-        {
-#ifdef DEBUG
-            std::cout << "Resolving executable from \"" << token << "\"" << std::endl;
-#endif
-
-            // `directory` may be empty
-            std::function<std::optional<std::string>(const std::string &directory, const std::string &filepath)> search;
-            search = [&search](const std::string &directory, const std::string &filepath) -> std::optional<std::string>
-            {
-                if (!utils::endswith(filepath, ".exe") && !utils::endswith(filepath, LITE_SHELL_SCRIPT_EXTENSION))
-                {
-                    auto result = search(directory, filepath + ".exe");
-                    if (result.has_value())
-                    {
-                        return result;
-                    }
-
-                    return search(directory, filepath + LITE_SHELL_SCRIPT_EXTENSION);
-                }
+        /** @brief The names and aliases of `_commands` at the last `compile_commands` call */
+        utils::PerfectHashMap<std::size_t, true> _compiled_commands;
 
-                try
-                {
-                    const auto fullpath = utils::join(directory, filepath);
-#ifdef DEBUG
-                    std::cout << "Searching " << fullpath << std::endl;
-#endif
-                    if (!utils::list_files(fullpath).empty())
-                    {
-                        return utils::get_absolute_path(fullpath);
-                    }
-                }
-                catch (std::exception &)
-                {
-                    // pass
-                }
+        /** @brief Parsed built-in command lines, cleared whenever the set of commands changes */
+        CommandCache _cache;
 
-                return std::nullopt;
-            };
-
-            // Search as an absolute path or a relative path to the working directory
-            auto result = search("", token);
-            if (result.has_value())
-            {
-                return result;
-            }
-
-            if (token.find('\\') == std::string::npos && token.find('/') == std::string::npos)
-            {
-                // token does not contain path separators
-                for (const auto &directory : get_resolve_order())
-                {
-                    auto result = search(directory, token);
-                    if (result.has_value())
-                    {
-                        return *result;
-                    }
-                }
-            }
+        const std::unique_ptr<Environment> _environment;
+        const std::unique_ptr<InputStream> _stream;
 
-            return std::nullopt;
-        }
+        /** @brief The cached working directory, only changed by `set_working_directory` */
+        std::optional<std::string> _working_directory;
 
-        void process_batch_file(const std::string &path) const
+        /** @brief Find a built-in command by name or alias, returning `NULL` if not found */
+        const std::shared_ptr<BaseCommand> *_find_command(const std::string_view &name) const
         {
-            // Warning: ifstream read in text mode may f*ck up in Windows: https://stackoverflow.com/a/8834004
-
-#ifdef DEBUG
-            std::cout << "Reading batch file: " << path << std::endl;
-#endif
-
-            auto file = CreateFileW(
-                utils::utf_convert(path).c_str(),
-                GENERIC_READ,
-                FILE_SHARE_READ,
-                NULL,
-                OPEN_EXISTING,
-                FILE_ATTRIBUTE_NORMAL,
-                NULL);
-
-            if (file == INVALID_HANDLE_VALUE)
+            auto index = _compiled_commands.find(name);
+            if (index != NULL)
             {
-                throw std::runtime_error(utils::last_error("Error when opening file"));
+                return &_wrappers[*index];
             }
 
-            auto _finalize = utils::Finalize(
-                [&file]()
-                {
-                    CloseHandle(file);
-                });
-
-            char buffer[LITE_SHELL_BUFFER_SIZE];
-            ZeroMemory(buffer, LITE_SHELL_BUFFER_SIZE);
-
-            std::stringstream stream;
-
-            DWORD read = LITE_SHELL_BUFFER_SIZE;
-            while (read == LITE_SHELL_BUFFER_SIZE)
+            // Only commands added after `compile_commands` need the dynamic table
+            if (_compiled_commands.size() == _commands.size())
             {
-                if (!ReadFile(file, buffer, LITE_SHELL_BUFFER_SIZE, &read, NULL))
-                {
-                    throw std::runtime_error(utils::last_error("Error when reading file"));
-                }
-
-                stream << std::string(buffer, buffer + read);
+                return NULL;
             }
 
-            _stream->append_footer(stream);
-            _stream->write(stream.str());
+            auto iter = _commands.find(name);
+            return iter == _commands.end() ? NULL : &_wrappers[iter->second];
         }
 
         /**
@@ -255,6 +148,44 @@ namespace liteshell
 
             _environment->set_value("PATH", path.substr(0, size));
             _environment->set_value("errorlevel", "0");
+
+            // Computed only when referenced
+            _environment->set_dynamic(
+                "cd",
+                [this]()
+                {
+                    return get_working_directory();
+                });
+            _environment->set_dynamic(
+                "time_ns",
+                []()
+                {
+                    return std::to_string(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+                });
+            _environment->set_dynamic(
+                "epoch",
+                []()
+                {
+                    return std::to_string(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+                });
+            _environment->set_dynamic(
+                "random",
+                []()
+                {
+                    return std::to_string(utils::random<int>(0, 32767));
+                });
+            _environment->set_dynamic(
+                "jobs",
+                [this]()
+                {
+                    std::size_t count = 0;
+                    for (auto &subprocess : _subprocesses)
+                    {
+                        count += subprocess->exit_code() == STILL_ACTIVE;
+                    }
+
+                    return std::to_string(count);
+                });
         }
 
         /** @brief Destructor for this object */
@@ -305,12 +236,43 @@ namespace liteshell
          */
         std::optional<std::shared_ptr<BaseCommand>> get_optional_command(const std::string &name) const
         {
-            auto iter = _commands.find(name);
-            if (iter == _commands.end())
+            auto found = _find_command(name);
+            if (found == NULL)
             {
                 return std::nullopt;
             }
-            return _wrappers[iter->second];
+            return *found;
+        }
+
+        /**
+         * @brief Get the working directory of the shell.
+         *
+         * The directory is queried once and cached until `set_working_directory` is called.
+         *
+         * @return The working directory
+         */
+        const std::string &get_working_directory()
+        {
+            if (!_working_directory.has_value())
+            {
+                _working_directory = utils::get_working_directory();
+            }
+
+            return *_working_directory;
+        }
+
+        /**
+         * @brief Change the working directory of the shell.
+         *
+         * @param path The new working directory
+         */
+        void set_working_directory(const std::string &path)
+        {
+            _working_directory.reset();
+            if (!SetCurrentDirectoryW(utils::utf_convert(path).c_str()))
+            {
+                throw std::runtime_error(utils::last_error(utils::format("Error when changing directory to \"%s\"", path.c_str())));
+            }
         }
 
         /**
@@ -336,6 +298,7 @@ namespace liteshell
                 throw std::runtime_error(utils::format("Command \"%s\" already exists", ptr->name.c_str()));
             }
 
+            _cache.clear();
             _wrappers.push_back(ptr);
             _commands[ptr->name] = _wrappers.size() - 1;
             for (auto &alias : ptr->aliases)
@@ -350,6 +313,26 @@ namespace liteshell
             return this;
         }
 
+        /**
+         * @brief Build a perfect hash table of the names and aliases of all commands added so far, to be called once
+         * all built-in commands are registered.
+         *
+         * Commands added afterwards (e.g. plugins) are still found, through a slower lookup.
+         *
+         * @return A pointer to the current client to allow fluent-style chaining
+         */
+        Client *compile_commands()
+        {
+            std::vector<std::pair<std::string, std::size_t>> entries;
+            for (auto &[name, index] : _commands)
+            {
+                entries.emplace_back(name, index);
+            }
+
+            _compiled_commands = utils::PerfectHashMap<std::size_t, true>(entries);
+            return this;
+        }
+
         /**
          * @brief Add a command to the internal list of commands.
          *
@@ -362,6 +345,18 @@ namespace liteshell
             return add_command(std::make_shared<T>());
         }
 
+        /** @brief Get the usage statistics of the parsed command line cache */
+        CommandCache::Statistics get_cache_statistics() const
+        {
+            return _cache.statistics();
+        }
+
+        /** @brief Remove all entries from the parsed command line cache */
+        void clear_cache()
+        {
+            _cache.clear();
+        }
+
         /**
          * @brief Search for a command that matches most closely to the given name.
          * @see `utils::fuzzy_search`
@@ -371,7 +366,7 @@ namespace liteshell
          */
         std::string fuzzy_command_search(const std::string &name) const
         {
-            std::vector<std::string> all;
+            std::vector<std::string_view> all;
             for (auto &wrapper : _wrappers)
             {
                 all.push_back(wrapper->name);
@@ -381,7 +376,7 @@ namespace liteshell
                 }
             }
 
-            return *utils::fuzzy_search(all.begin(), all.end(), name);
+            return std::string(*utils::fuzzy_search(all.begin(), all.end(), name));
         }
 
         /**
@@ -398,13 +393,13 @@ namespace liteshell
             {
                 process_command(
                     _stream->getline(
-                        []()
+                        [this]()
                         {
                             SYSTEMTIME time;
                             GetLocalTime(&time);
                             std::cout << utils::format("\n[%d:%d:%d]", time.wHour, time.wMinute, time.wSecond);
                             utils::style_print("liteshell~", FOREGROUND_BLUE | FOREGROUND_INTENSITY);
-                            std::cout << utils::get_working_directory() << ">";
+                            std::cout << get_working_directory() << ">";
                         },
                         0));
             }
@@ -421,40 +416,84 @@ namespace liteshell
          */
         void process_command(const std::string &message)
         {
-            _environment->set_value("cd", utils::get_working_directory().c_str());
             try
             {
-                auto stripped_message = utils::strip(_environment->resolve(utils::strip(message)));
+                // Temporaries of this call are released at once, nested calls (e.g. from scripts) have their own arena
+                utils::Arena<LITE_SHELL_COMMAND_ARENA_SIZE> arena;
+                const auto resolved = _environment->resolve(utils::strip_view(message), &arena);
+                const auto stripped = utils::strip_view(resolved);
+
+                // A line with variable references resolves differently on each iteration of a loop, caching it
+                // would only evict the stable entries
+                const bool cacheable = message.find('$') == std::string::npos;
 #ifdef DEBUG
-                std::cout << utils::format("Processing command \"%s\"", stripped_message.c_str()) << std::endl;
+                std::cout << "Processing command \"" << stripped << "\"" << std::endl;
 #endif
 
-                if (stripped_message.empty() || stripped_message[0] == ':')
+                if (stripped.empty() || stripped[0] == ':')
                 {
                     // pass
                 }
+                else if (auto cached = cacheable ? _cache.find(stripped, message) : NULL)
+                {
+                    // Keep the entry alive even if a nested command evicts it
+                    const auto command = cached->command;
+                    const auto context = cached->context;
+#ifdef DEBUG
+                    std::cout << "Matched cached command \"" << command->name << "\"" << std::endl;
+#endif
+
+                    auto errorlevel = command->run(*context);
+                    _environment->set_value("errorlevel", std::to_string(errorlevel));
+                }
                 else
                 {
-                    auto context = Context::get_context(_instance, stripped_message, message);
-                    try
+                    // Tokenize into the arena: the tokens are only copied out if a context needs them
+                    std::pmr::string buffer(&arena);
+                    const auto tokens = utils::tokenize(stripped, buffer, std::pmr::polymorphic_allocator<std::string_view>(&arena));
+                    if (tokens.empty())
+                    {
+                        throw std::invalid_argument("No command provided");
+                    }
+
+                    auto found = _find_command(tokens[0]);
+                    if (found != NULL)
                     {
-                        auto wrapper = _get_command(context);
+                        const auto &wrapper = *found;
 
 #ifdef DEBUG
                         std::cout << "Matched command \"" << wrapper->name << "\"" << std::endl;
 #endif
 
-                        auto constraint = wrapper->constraint;
-                        auto errorlevel = wrapper->run(context.parse(constraint));
+                        // Bind the tokens directly against the constraint of the matched command
+                        const std::string stripped_message(stripped);
+                        std::vector<std::string> owned_tokens(tokens.begin(), tokens.end());
+
+                        DWORD errorlevel;
+                        if (cacheable)
+                        {
+                            // The context outlives this call in the cache, so it is allocated on the heap
+                            const auto context = std::make_shared<const Context>(
+                                Context::get_context(this, stripped_message, message, std::move(owned_tokens), &wrapper->constraint));
+                            _cache.insert(stripped_message, {wrapper, context});
+                            errorlevel = wrapper->run(*context);
+                        }
+                        else
+                        {
+                            const auto context = Context::get_context(this, stripped_message, message, std::move(owned_tokens), &wrapper->constraint);
+                            errorlevel = wrapper->run(context);
+                        }
+
                         _environment->set_value("errorlevel", std::to_string(errorlevel));
                     }
-                    catch (CommandNotFound &)
+                    else
                     {
 #ifdef DEBUG
                         std::cout << "No command found. Resolving as an executable/script." << std::endl;
 #endif
 
-                        auto executable = resolve(context.tokens[0]);
+                        const std::string name(tokens[0]);
+                        auto executable = resolve(name);
 
                         if (executable.has_value()) // Is an executable or batch file
                         {
@@ -464,14 +503,20 @@ namespace liteshell
 
                             if (utils::endswith(*executable, ".exe"))
                             {
-                                auto final_context = context.replace_call(*executable);
+                                // Replace the call and strip the background suffix without building a context
+                                // (see `Context::replace_call` and `Context::strip_background_request`)
+                                std::string command_line(*executable);
+                                command_line += stripped.substr(tokens[0].size());
+
+                                const bool background = tokens.size() > 1 && tokens.back().size() == 1 && tokens.back()[0] == Context::BACKGROUND_SUFFIX;
+                                if (background)
+                                {
+                                    command_line.resize(command_line.rfind(Context::BACKGROUND_SUFFIX));
+                                }
 
-                                auto subprocess = spawn_subprocess(
-                                    final_context.strip_background_request().message,
-                                    final_context.is_background_request(),
-                                    false);
+                                auto subprocess = spawn_subprocess(command_line, background, false);
                                 _environment->set_value("pid", std::to_string(subprocess->pid()));
-                                if (final_context.is_background_request())
+                                if (background)
                                 {
                                     _environment->set_value("errorlevel", "0");
                                 }
@@ -483,15 +528,24 @@ namespace liteshell
                             }
                             else
                             {
-                                process_batch_file(*executable);
+                                process_batch_file(*executable, false);
                             }
                         }
                         else
                         {
-                            throw;
+                            throw CommandNotFound(
+                                name,
+                                [this, name]()
+                                {
+                                    return fuzzy_command_search(name);
+                                });
                         }
                     }
                 }
+
+#ifdef DEBUG
+                std::cout << utils::format("Command arena: %u allocations, %u bytes", arena.allocations(), arena.bytes()) << std::endl;
+#endif
             }
             catch (std::exception &error)
             {
@@ -499,6 +553,140 @@ namespace liteshell
             }
         }
 
+        /**
+         * @brief Find an executable that `token` points to.
+         *
+         * The function will first look in the current working directory, then in the directories specified in `resolve_order`.
+         *
+         * @see https://stackoverflow.com/a/605139
+         * @param token The token to resolve. This token may be a relative or absolute path.
+         * @return The path to the executable if found, `std::nullopt` otherwise.
+         */
+        std::optional<std::string> resolve(const std::string &token) const
+        {
+#ifdef DEBUG
+            std::cout << "Resolving executable from \"" << token << "\"" << std::endl;
+#endif
+
+            // `directory` may be empty
+            std::function<std::optional<std::string>(const std::string &directory, const std::string &filepath)> search;
+            search = [&search](const std::string &directory, const std::string &filepath) -> std::optional<std::string>
+            {
+                if (!utils::endswith(filepath, ".exe") && !utils::endswith(filepath, LITE_SHELL_SCRIPT_EXTENSION))
+                {
+                    auto result = search(directory, filepath + ".exe");
+                    if (result.has_value())
+                    {
+                        return result;
+                    }
+
+                    return search(directory, filepath + LITE_SHELL_SCRIPT_EXTENSION);
+                }
+
+                try
+                {
+                    const auto fullpath = utils::join(directory, filepath);
+#ifdef DEBUG
+                    std::cout << "Searching " << fullpath << std::endl;
+#endif
+                    if (!utils::list_files(fullpath).empty())
+                    {
+                        return utils::get_absolute_path(fullpath);
+                    }
+                }
+                catch (std::exception &)
+                {
+                    // pass
+                }
+
+                return std::nullopt;
+            };
+
+            // Search as an absolute path or a relative path to the working directory
+            auto result = search("", token);
+            if (result.has_value())
+            {
+                return result;
+            }
+
+            if (token.find('\\') == std::string::npos && token.find('/') == std::string::npos)
+            {
+                // token does not contain path separators
+                for (const auto &directory : get_resolve_order())
+                {
+                    auto result = search(directory, token);
+                    if (result.has_value())
+                    {
+                        return *result;
+                    }
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        /**
+         * @brief Insert the content of a batch script into the input stream.
+         *
+         * Local scopes that are still open when the script reaches its end (see `Environment::push_scope`) are
+         * closed automatically, similar to an implicit `endlocal`.
+         *
+         * @param path The path to the batch script
+         * @param local Whether to run the script within a new local scope
+         */
+        void process_batch_file(const std::string &path, const bool local) const
+        {
+            // Warning: ifstream read in text mode may f*ck up in Windows: https://stackoverflow.com/a/8834004
+
+#ifdef DEBUG
+            std::cout << "Reading batch file: " << path << std::endl;
+#endif
+
+            auto file = CreateFileW(
+                utils::utf_convert(path).c_str(),
+                GENERIC_READ,
+                FILE_SHARE_READ,
+                NULL,
+                OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL,
+                NULL);
+
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                throw std::runtime_error(utils::last_error("Error when opening file"));
+            }
+
+            auto _finalize = utils::Finalize(
+                [&file]()
+                {
+                    CloseHandle(file);
+                });
+
+            char buffer[LITE_SHELL_BUFFER_SIZE];
+            ZeroMemory(buffer, LITE_SHELL_BUFFER_SIZE);
+
+            std::stringstream stream;
+
+            DWORD read = LITE_SHELL_BUFFER_SIZE;
+            while (read == LITE_SHELL_BUFFER_SIZE)
+            {
+                if (!ReadFile(file, buffer, LITE_SHELL_BUFFER_SIZE, &read, NULL))
+                {
+                    throw std::runtime_error(utils::last_error("Error when reading file"));
+                }
+
+                stream << std::string(buffer, buffer + read);
+            }
+
+            _stream->append_footer(stream, utils::format("_endlocal %u", _environment->scope_depth()));
+            _stream->write(stream.str());
+
+            if (local)
+            {
+                _environment->push_scope();
+            }
+        }
+
         /**
          * @brief Split the PATH environment variable into a vector of paths.
          *
@@ -530,6 +718,12 @@ namespace liteshell
                 flags |= CREATE_NEW_CONSOLE;
             }
 
+            auto environment_block = _environment->get_export_block();
+            if (environment_block != NULL)
+            {
+                flags |= CREATE_UNICODE_ENVIRONMENT;
+            }
+
             STARTUPINFOW startup_info;
             ZeroMemory(&startup_info, sizeof(startup_info));
             startup_info.cb = sizeof(startup_info);
@@ -542,7 +736,7 @@ namespace liteshell
                 NULL,                               // lpThreadAttributes
                 TRUE,                               // bInheritHandles
                 flags,                              // dwCreationFlags
-                NULL,                               // lpEnvironment
+                (LPVOID)environment_block,          // lpEnvironment
                 NULL,                               // lpCurrentDirectory
                 &startup_info,                      // lpStartupInfo
                 &process_info                       // lpProcessInformation
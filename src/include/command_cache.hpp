@@ -0,0 +1,136 @@
+#pragma once
+
+#include "base.hpp"
+
+/** @brief The maximum number of command lines kept by a `CommandCache` */
+#define LITE_SHELL_COMMAND_CACHE_SIZE 256
+
+/** @brief Command lines longer than this (in bytes) are not cached */
+#define LITE_SHELL_COMMAND_CACHE_MAX_LINE 4096
+
+namespace liteshell
+{
+    /**
+     * @brief A bounded LRU cache of parsed command lines
+     *
+     * Only lines without variable references are cached (a line such as `eval -ms i "$i + 1"` would resolve to
+     * a new key on every iteration of a loop and evict the stable entries).
+     *
+     * Entries are keyed by the command message after variable resolution and hold the matched built-in command
+     * with the `Context` bound to its constraint. Executing a cached line therefore skips tokenizing, the command
+     * lookup and argument binding.
+     *
+     * Contexts are held by `std::shared_ptr`, so an entry evicted while its command is still running (e.g. by
+     * nested commands) stays alive until the command returns.
+     */
+    class CommandCache
+    {
+    public:
+        /** @brief A cached command line */
+        struct Entry
+        {
+            /** @brief The matched built-in command */
+            const std::shared_ptr<BaseCommand> command;
+
+            /** @brief The context bound to the constraint of `command` */
+            const std::shared_ptr<const Context> context;
+        };
+
+        /** @brief Usage statistics of a `CommandCache` */
+        struct Statistics
+        {
+            std::size_t size, capacity, hits, misses, evictions, memory;
+        };
+
+    private:
+        struct _Node
+        {
+            const std::string key;
+            const Entry entry;
+            const std::size_t memory;
+        };
+
+        /** @brief The most recently used entry first */
+        std::list<_Node> _nodes;
+
+        /** @brief The keys are views into the nodes */
+        std::unordered_map<std::string_view, std::list<_Node>::iterator> _index;
+
+        std::size_t _hits = 0, _misses = 0, _evictions = 0, _memory = 0;
+
+        void _erase(const std::list<_Node>::iterator &iter)
+        {
+            _memory -= iter->memory;
+            _index.erase(iter->key);
+            _nodes.erase(iter);
+        }
+
+    public:
+        /**
+         * @brief Look up a command line, marking it as the most recently used
+         *
+         * @param message The command message after variable resolution
+         * @param original_message The original message, which must match the cached one too (commands such as
+         * `if` read it)
+         * @return The cached entry, or `NULL` if not found
+         */
+        const Entry *find(const std::string_view &message, const std::string &original_message)
+        {
+            auto iter = _index.find(message);
+            if (iter == _index.end() || iter->second->entry.context->original_message != original_message)
+            {
+                _misses++;
+                return NULL;
+            }
+
+            _hits++;
+            _nodes.splice(_nodes.begin(), _nodes, iter->second);
+            return &iter->second->entry;
+        }
+
+        /**
+         * @brief Cache a parsed command line, evicting the least recently used one if the cache is full
+         *
+         * @param message The command message after variable resolution
+         * @param entry The matched command and its bound context
+         */
+        void insert(const std::string &message, const Entry &entry)
+        {
+            if (message.size() > LITE_SHELL_COMMAND_CACHE_MAX_LINE)
+            {
+                return;
+            }
+
+            auto iter = _index.find(message);
+            if (iter != _index.end())
+            {
+                _erase(iter->second);
+            }
+
+            if (_nodes.size() == LITE_SHELL_COMMAND_CACHE_SIZE)
+            {
+                _erase(std::prev(_nodes.end()));
+                _evictions++;
+            }
+
+            const auto memory = sizeof(_Node) + 2 * message.capacity() + entry.context->memory_usage();
+            _nodes.push_front(_Node{message, entry, memory});
+            _index.emplace(_nodes.front().key, _nodes.begin());
+            _memory += memory;
+        }
+
+        /** @brief Remove all entries (the statistics are kept) */
+        void clear()
+        {
+            _index.clear();
+            _nodes.clear();
+            _memory = 0;
+        }
+
+        /** @brief Get the usage statistics of this cache */
+        Statistics statistics() const
+        {
+            return {_nodes.size(), LITE_SHELL_COMMAND_CACHE_SIZE, _hits, _misses, _evictions, _memory};
+        }
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "format.hpp"
+#include "perfect_hash.hpp"
 #include "utils.hpp"
 
 namespace liteshell
@@ -158,6 +159,10 @@ namespace liteshell
      */
     class Option : public _BaseArgument, _SupportsMultiplePositionalArguments
     {
+    private:
+        std::vector<std::string> _names;
+        std::vector<std::vector<std::string>> _qualified_names;
+
     public:
         /**
          * @brief The short name of the option e.g. `-v`
@@ -223,27 +228,47 @@ namespace liteshell
                     throw std::invalid_argument(utils::format("\"%s\" is not a valid option long name", long_name->c_str()));
                 }
             }
-        }
 
-        /**
-         * @brief Get all names of this option
-         *
-         * @return A vector containing all names of this option (length 1 or 2)
-         */
-        std::vector<std::string> names() const
-        {
-            std::vector<std::string> result;
             if (short_name.has_value())
             {
-                result.push_back(*short_name);
+                _names.push_back(*short_name);
             }
 
             if (long_name.has_value())
             {
-                result.push_back(*long_name);
+                _names.push_back(*long_name);
             }
 
-            return result;
+            for (auto &name : _names)
+            {
+                auto &qualified = _qualified_names.emplace_back();
+                for (auto &argument : positional)
+                {
+                    qualified.push_back(name + " " + argument.name);
+                }
+            }
+        }
+
+        /**
+         * @brief Get all names of this option
+         *
+         * @return A vector containing all names of this option (length 1 or 2)
+         */
+        const std::vector<std::string> &names() const
+        {
+            return _names;
+        }
+
+        /**
+         * @brief Get the qualified names of the positional arguments of this option, under which their values are
+         * stored in `Context::values` (e.g. `--sort name`)
+         *
+         * @param name_index The index of the option name in `names()`
+         * @return A vector containing one qualified name per positional argument
+         */
+        const std::vector<std::string> &qualified_names(const std::size_t name_index) const
+        {
+            return _qualified_names[name_index];
         }
 
         /** @copydoc _BaseArgument::display */
@@ -267,12 +292,40 @@ namespace liteshell
         }
     };
 
-    /** @brief Represents the constraints for a command */
+    /**
+     * @brief A precompiled handle to an argument of a `CommandConstraint`
+     * @see `CommandConstraint::slot`
+     */
+    struct ArgumentSlot
+    {
+        /** @brief The index of the argument in the slot vector of a bound `Context` */
+        std::size_t index;
+    };
+
+    /**
+     * @brief Represents the constraints for a command
+     *
+     * Adding an option compiles the binding table used when parsing command lines: a perfect hash table from
+     * option names to indices in `get_options_vector()`, and a bitset of the letters of the short options (to
+     * recognize combined flags such as `-abc`). Options are added when commands are constructed, so parsing a
+     * command line only performs lookups.
+     *
+     * Each argument is also assigned a slot, i.e. an index in the flat argument storage of a bound `Context`:
+     * - Positional arguments use slots `[0, positional.size())`, in order
+     * - Each option then uses one slot for its presence, followed by one slot per positional argument of the
+     *   option (shared by all names of the option, e.g. `-s var` and `--save var`)
+     */
     class CommandConstraint : public _SupportsMultiplePositionalArguments
     {
     private:
         std::vector<Option> options;
-        std::map<std::string, std::size_t> options_map;
+        utils::PerfectHashMap<std::size_t> _option_slots;
+        std::bitset<128> _short_flags;
+
+        utils::PerfectHashMap<std::size_t> _argument_slots;
+        std::vector<std::size_t> _option_slot_bases;
+        std::vector<std::string> _slot_names;
+        std::size_t _slot_count = 0;
 
         void check_duplicate_option_name(const std::string &name) const
         {
@@ -282,9 +335,62 @@ namespace liteshell
             }
         }
 
+        void _compile()
+        {
+            std::vector<std::pair<std::string, std::size_t>> entries;
+            _short_flags.reset();
+            for (std::size_t i = 0; i < options.size(); i++)
+            {
+                for (auto &name : options[i].names())
+                {
+                    entries.emplace_back(name, i);
+                }
+
+                if (options[i].short_name.has_value())
+                {
+                    _short_flags.set(static_cast<unsigned char>((*options[i].short_name)[1]));
+                }
+            }
+
+            _option_slots = utils::PerfectHashMap<std::size_t>(entries);
+
+            entries.clear();
+            _option_slot_bases.clear();
+            _slot_names.clear();
+            _slot_count = 0;
+            for (auto &argument : positional)
+            {
+                entries.emplace_back(argument.name, _slot_count++);
+                _slot_names.push_back(argument.name);
+            }
+
+            for (auto &option : options)
+            {
+                _option_slot_bases.push_back(_slot_count);
+                const auto &names = option.names();
+                _slot_names.push_back(names[0]);
+                _slot_names.insert(_slot_names.end(), option.qualified_names(0).begin(), option.qualified_names(0).end());
+                for (std::size_t i = 0; i < names.size(); i++)
+                {
+                    entries.emplace_back(names[i], _slot_count);
+                    for (std::size_t j = 0; j < option.positional.size(); j++)
+                    {
+                        entries.emplace_back(option.qualified_names(i)[j], _slot_count + 1 + j);
+                    }
+                }
+
+                _slot_count += 1 + option.positional.size();
+            }
+
+            _argument_slots = utils::PerfectHashMap<std::size_t>(entries);
+        }
+
     public:
         /** @brief Construct a `CommandConstraint` with no positional argument */
-        CommandConstraint() : _SupportsMultiplePositionalArguments({}) {}
+        CommandConstraint() : _SupportsMultiplePositionalArguments({})
+        {
+            _compile();
+        }
 
         /**
          * @brief Construct a `CommandConstraint` with the specified positional arguments
@@ -292,7 +398,10 @@ namespace liteshell
          * @param positional The positional arguments for this command
          */
         CommandConstraint(const std::vector<PositionalArgument> &positional)
-            : _SupportsMultiplePositionalArguments(positional) {}
+            : _SupportsMultiplePositionalArguments(positional)
+        {
+            _compile();
+        }
 
         /**
          * @brief Construct a `CommandConstraint` with 1 positional argument
@@ -414,9 +523,130 @@ namespace liteshell
                    PositionalArgument(name_5, help_5, many, required_5)}) {}
 
         /** @brief Whether there exists an `Option` with the given name */
-        bool has_option(const std::string &name) const
+        bool has_option(const std::string_view &name) const
         {
-            return options_map.find(name) != options_map.end();
+            return _option_slots.find(name) != NULL;
+        }
+
+        /**
+         * @brief Find an `Option` by any of its names, without copying it
+         *
+         * @param name The name of the option
+         * @return A pointer to the option (an element of `get_options_vector()`), or `NULL` if not found
+         */
+        const Option *find_option(const std::string_view &name) const
+        {
+            auto slot = _option_slots.find(name);
+            return slot == NULL ? NULL : &options[*slot];
+        }
+
+        /**
+         * @brief Find a short `Option` by its letter
+         *
+         * @param letter The letter of the option, e.g. `v` for `-v`
+         * @return A pointer to the option (an element of `get_options_vector()`), or `NULL` if not found
+         */
+        const Option *find_short_option(const char letter) const
+        {
+            if (!is_short_flag(letter))
+            {
+                return NULL;
+            }
+
+            const char name[2] = {'-', letter};
+            return find_option(std::string_view(name, 2));
+        }
+
+        /** @brief Whether `-<letter>` is the short name of an `Option` */
+        bool is_short_flag(const char letter) const
+        {
+            auto index = static_cast<unsigned char>(letter);
+            return index < _short_flags.size() && _short_flags.test(index);
+        }
+
+        /**
+         * @brief Whether a token combines several short options, e.g. `-abc` for `-a -b -c`
+         *
+         * @param token The token to check
+         * @return Whether the token is longer than 2 characters, starts with `-` and each following letter is a
+         * short option
+         */
+        bool is_flag_group(const std::string_view &token) const
+        {
+            if (token.size() <= 2 || token[0] != '-')
+            {
+                return false;
+            }
+
+            for (std::size_t i = 1; i < token.size(); i++)
+            {
+                if (!is_short_flag(token[i]))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /** @brief The number of argument slots of a `Context` bound to this constraint */
+        std::size_t slot_count() const
+        {
+            return _slot_count;
+        }
+
+        /**
+         * @brief Find the slot of an argument
+         *
+         * @param name The name of a positional argument, the name of an option (its presence) or the qualified
+         * name of a positional argument of an option (e.g. `-s var`)
+         * @return The slot of the argument, or `std::nullopt` if not found
+         */
+        std::optional<ArgumentSlot> find_slot(const std::string_view &name) const
+        {
+            auto slot = _argument_slots.find(name);
+            return slot == NULL ? std::nullopt : std::make_optional(ArgumentSlot{*slot});
+        }
+
+        /**
+         * @brief Get the slot of an argument, typically once when a command is constructed
+         * @see `find_slot`
+         *
+         * @param name The name of the argument
+         * @return The slot of the argument
+         * @throw `std::invalid_argument` if the argument does not exist
+         */
+        ArgumentSlot slot(const std::string_view &name) const
+        {
+            auto result = find_slot(name);
+            if (!result.has_value())
+            {
+                throw std::invalid_argument(utils::format("Argument \"%s\" does not exist", std::string(name).c_str()));
+            }
+
+            return *result;
+        }
+
+        /**
+         * @brief Get the name of an argument slot (for options, the first name in `Option::names()`)
+         *
+         * @param slot The slot of the argument
+         * @return The name of the argument
+         */
+        const std::string &slot_name(const ArgumentSlot slot) const
+        {
+            return _slot_names.at(slot.index);
+        }
+
+        /**
+         * @brief Get the first slot of an option (its presence), followed by one slot per positional argument
+         *
+         * @param option A pointer to an element of `get_options_vector()`
+         * @return The first slot of the option
+         */
+        ArgumentSlot option_slot(const Option *option) const
+        {
+            return ArgumentSlot{_option_slot_bases[option - options.data()]};
         }
 
         /** @brief Get a mapping from option names to their corresponding options */
@@ -435,7 +665,7 @@ namespace liteshell
         }
 
         /** @brief Get a vector of all options with no duplication */
-        std::vector<Option> get_options_vector() const
+        const std::vector<Option> &get_options_vector() const
         {
             return options;
         }
@@ -448,13 +678,13 @@ namespace liteshell
          */
         CommandConstraint &add_option(const Option &option)
         {
-            options.push_back(option);
             for (auto &name : option.names())
             {
                 check_duplicate_option_name(name);
-                options_map[name] = options.size() - 1;
             }
 
+            options.push_back(option);
+            _compile();
             return *this;
         }
 
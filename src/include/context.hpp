@@ -6,6 +6,109 @@
 
 namespace liteshell
 {
+    /**
+     * @brief A read-only range over the values of an argument
+     *
+     * The values are the tokens of the `Context` the range was obtained from, which must outlive the range.
+     */
+    class ArgumentValues
+    {
+    private:
+        const std::string *_tokens = NULL;
+        const std::uint32_t *_begin = NULL, *_end = NULL;
+
+    public:
+        class iterator
+        {
+        private:
+            const std::string *_tokens;
+            const std::uint32_t *_position;
+
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef std::string value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const std::string *pointer;
+            typedef const std::string &reference;
+
+            iterator(const std::string *tokens, const std::uint32_t *position) : _tokens(tokens), _position(position) {}
+
+            reference operator*() const
+            {
+                return _tokens[*_position];
+            }
+
+            pointer operator->() const
+            {
+                return &_tokens[*_position];
+            }
+
+            iterator &operator++()
+            {
+                _position++;
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                auto result = *this;
+                _position++;
+                return result;
+            }
+
+            bool operator==(const iterator &other) const
+            {
+                return _position == other._position;
+            }
+
+            bool operator!=(const iterator &other) const
+            {
+                return _position != other._position;
+            }
+        };
+
+        /** @brief Construct an empty range */
+        ArgumentValues() {}
+
+        /**
+         * @brief Construct a range of tokens
+         *
+         * @param tokens The tokens of a `Context`
+         * @param begin A pointer to the first token index
+         * @param end A pointer after the last token index
+         */
+        ArgumentValues(const std::string *tokens, const std::uint32_t *begin, const std::uint32_t *end)
+            : _tokens(tokens), _begin(begin), _end(end) {}
+
+        /** @brief The number of values */
+        std::size_t size() const
+        {
+            return _end - _begin;
+        }
+
+        /** @brief Whether there is no value */
+        bool empty() const
+        {
+            return _begin == _end;
+        }
+
+        /** @brief Get a value by index, without bounds checking */
+        const std::string &operator[](const std::size_t index) const
+        {
+            return _tokens[_begin[index]];
+        }
+
+        iterator begin() const
+        {
+            return iterator(_tokens, _begin);
+        }
+
+        iterator end() const
+        {
+            return iterator(_tokens, _end);
+        }
+    };
+
     /**
      * @brief The command invocation context.
      *
@@ -17,22 +120,40 @@ namespace liteshell
     class Context
     {
     private:
+        /** @brief The token indices of the argument values, grouped by slot */
+        std::vector<std::uint32_t> _values;
+
+        /** @brief The values of slot `i` are `_values[_offsets[i]]` to `_values[_offsets[i + 1]]` (exclusive) */
+        std::vector<std::uint32_t> _offsets;
+
+        /** @brief The presence bit of each slot */
+        std::vector<bool> _present;
+
         Context(
-            const std::string &message,
-            const std::string &original_message,
-            const std::vector<std::string> &tokens,
-            const std::map<std::string, std::vector<std::string>> &values,
-            const std::set<std::string> &present,
-            const std::shared_ptr<class Client> &client,
-            const std::optional<CommandConstraint> &constraint)
-            : message(message),
-              original_message(original_message),
-              tokens(tokens),
-              values(values),
-              present(present),
+            std::string message,
+            std::string original_message,
+            std::vector<std::string> tokens,
+            class Client *client,
+            const CommandConstraint *constraint)
+            : message(std::move(message)),
+              original_message(std::move(original_message)),
+              tokens(std::move(tokens)),
               client(client),
               constraint(constraint) {}
 
+        /**
+         * @brief Bind the tokens of this context to the argument slots of its constraint
+         *
+         * The tokens are walked twice: the first walk validates them and counts the values of each slot, the
+         * second one stores the values grouped by slot. No temporary storage is allocated.
+         */
+        void _bind();
+
+        std::optional<ArgumentSlot> _find_slot(const std::string_view &name) const
+        {
+            return constraint == NULL ? std::nullopt : constraint->find_slot(name);
+        }
+
     public:
         /** @brief A suffix indicating that a command message should be run in a background */
         static const char BACKGROUND_SUFFIX = '%';
@@ -46,47 +167,189 @@ namespace liteshell
         /** @brief The list of tokens after parsing the message: e.g. `args a b -c d` will give `[args, a, b, -c, d]`. */
         const std::vector<std::string> tokens;
 
-        /** @brief A mapping of argument names to their values. */
-        const std::map<std::string, std::vector<std::string>> values;
+        /**
+         * @brief A pointer to the client that contains the command being executed.
+         *
+         * The context does not own the client: the client outlives all contexts it creates, including those kept
+         * in its cache of parsed command lines.
+         */
+        class Client *const client;
 
-        /** @brief The options presenting in the command. */
-        const std::set<std::string> present;
+        /**
+         * @brief The arguments constraint of this context object, or `NULL` if the arguments are not bound.
+         *
+         * The constraint is owned by the matched command and outlives the context.
+         */
+        const CommandConstraint *const constraint;
 
-        /** @brief A pointer to the client that contains the command being executed. */
-        const std::shared_ptr<class Client> client;
+        /**
+         * @brief Whether an argument is present.
+         *
+         * @param slot The slot of the argument (see `CommandConstraint::slot`)
+         * @return Whether the argument (or option) was specified in the command line
+         */
+        bool has(const ArgumentSlot slot) const
+        {
+            return slot.index < _present.size() && _present[slot.index];
+        }
 
-        /** @brief The arguments constraint of this context object */
-        const std::optional<CommandConstraint> constraint;
+        /**
+         * @brief Whether an argument is present.
+         *
+         * @param name The name of a positional argument, an option (e.g. `-s`) or an argument of an option (e.g. `-s var`)
+         * @return Whether the argument (or option) was specified in the command line
+         */
+        bool has(const std::string_view &name) const
+        {
+            auto slot = _find_slot(name);
+            return slot.has_value() && has(*slot);
+        }
 
         /**
          * @brief Get the first value of an argument.
          *
-         * Roughly equivalent to `.values[name][0]`.
-         * @see `values`
+         * @param slot The slot of the argument (see `CommandConstraint::slot`)
+         * @return The first value of the argument
+         * @throw `ArgumentMissingError` if the argument has no value
+         */
+        const std::string &get(const ArgumentSlot slot) const
+        {
+            if (!has(slot) || _offsets[slot.index] == _offsets[slot.index + 1])
+            {
+                throw ArgumentMissingError(constraint == NULL ? std::to_string(slot.index) : constraint->slot_name(slot));
+            }
+
+            return tokens[_values[_offsets[slot.index]]];
+        }
+
+        /**
+         * @brief Get the first value of an argument.
          *
          * @param name The name of the argument to get
          * @return The first value of the argument
+         * @throw `ArgumentMissingError` if the argument has no value
+         */
+        const std::string &get(const std::string_view &name) const
+        {
+            auto slot = _find_slot(name);
+            if (!slot.has_value() || !has(*slot))
+            {
+                throw ArgumentMissingError(std::string(name));
+            }
+
+            return get(*slot);
+        }
+
+        /**
+         * @brief Get the first value of an argument if it is present, without throwing.
+         *
+         * @param slot The slot of the argument (see `CommandConstraint::slot`)
+         * @return The first value of the argument, or `std::nullopt` if the argument has no value
+         */
+        std::optional<std::string> get_optional(const ArgumentSlot slot) const
+        {
+            if (!has(slot) || _offsets[slot.index] == _offsets[slot.index + 1])
+            {
+                return std::nullopt;
+            }
+
+            return tokens[_values[_offsets[slot.index]]];
+        }
+
+        /**
+         * @brief Get the first value of an argument if it is present, without throwing.
+         *
+         * @param name The name of the argument
+         * @return The first value of the argument, or `std::nullopt` if the argument has no value
+         */
+        std::optional<std::string> get_optional(const std::string_view &name) const
+        {
+            auto slot = _find_slot(name);
+            return slot.has_value() ? get_optional(*slot) : std::nullopt;
+        }
+
+        /**
+         * @brief Get the first value of an argument, or a default value if it is absent.
+         *
+         * @param slot The slot of the argument (see `CommandConstraint::slot`)
+         * @param default_value The value to return if the argument has no value
+         * @return The first value of the argument, or `default_value`
          */
-        std::string get(const std::string &name) const
+        std::string value_or(const ArgumentSlot slot, const std::string &default_value) const
         {
-            auto iter = values.find(name);
-            if (iter == values.end())
+            if (!has(slot) || _offsets[slot.index] == _offsets[slot.index + 1])
             {
-                throw ArgumentMissingError(name);
+                return default_value;
             }
 
-            return iter->second[0];
+            return tokens[_values[_offsets[slot.index]]];
+        }
+
+        /**
+         * @brief Get the first value of an argument, or a default value if it is absent.
+         *
+         * @param name The name of the argument
+         * @param default_value The value to return if the argument has no value
+         * @return The first value of the argument, or `default_value`
+         */
+        std::string value_or(const std::string_view &name, const std::string &default_value) const
+        {
+            auto slot = _find_slot(name);
+            return slot.has_value() ? value_or(*slot, default_value) : default_value;
+        }
+
+        /**
+         * @brief Get all values of an argument.
+         *
+         * @param slot The slot of the argument (see `CommandConstraint::slot`)
+         * @return The values of the argument, empty if the argument is not present
+         */
+        ArgumentValues get_all(const ArgumentSlot slot) const
+        {
+            if (!has(slot))
+            {
+                return ArgumentValues();
+            }
+
+            return ArgumentValues(tokens.data(), _values.data() + _offsets[slot.index], _values.data() + _offsets[slot.index + 1]);
+        }
+
+        /**
+         * @brief Get all values of an argument.
+         *
+         * @param name The name of the argument
+         * @return The values of the argument, empty if the argument is not present
+         */
+        ArgumentValues get_all(const std::string_view &name) const
+        {
+            auto slot = _find_slot(name);
+            return slot.has_value() ? get_all(*slot) : ArgumentValues();
+        }
+
+        /** @brief An estimate of the memory owned by this context in bytes */
+        std::size_t memory_usage() const
+        {
+            std::size_t result = sizeof(Context) + message.capacity() + original_message.capacity();
+            for (auto &token : tokens)
+            {
+                result += sizeof(std::string) + token.capacity();
+            }
+
+            result += (_values.capacity() + _offsets.capacity()) * sizeof(std::uint32_t) + _present.capacity() / 8;
+            return result;
         }
 
         /**
          * @brief Parse this context with another constraint.
          *
-         * @param constraint The new constraint to parse the context with
+         * The tokens of this context are reused rather than splitting the message again.
+         *
+         * @param constraint The new constraint to parse the context with (or `NULL`)
          * @return A new context with the new constraint applied
          */
-        Context parse(const std::optional<CommandConstraint> &constraint) const
+        Context parse(const CommandConstraint *constraint) const
         {
-            return get_context(client, message, original_message, constraint);
+            return get_context(client, message, original_message, std::vector<std::string>(tokens), constraint);
         }
 
         /**
@@ -108,7 +371,11 @@ namespace liteshell
             std::vector<std::string> new_tokens(tokens);
             new_tokens[0] = token;
 
-            return Context(new_message, original_message, new_tokens, values, present, client, constraint);
+            Context result(new_message, original_message, new_tokens, client, constraint);
+            result._values = _values;
+            result._offsets = _offsets;
+            result._present = _present;
+            return result;
         }
 
         /**
@@ -151,189 +418,232 @@ namespace liteshell
          * @param client A pointer to the Client object
          * @param message The message to construct the context from
          * @param original_message The original message (without environment variables unresolved)
-         * @param constraint The constraint to parse the context with (if `std::nullopt` is provided, the
-         * resulting `Context` will have its `Context::values` and `Context::present` be empty containers)
+         * @param constraint The constraint to parse the context with (if `NULL` is provided, the resulting
+         * `Context` will have its `Context::values` and `Context::present` be empty containers)
          * @return A new context object
          */
         static Context get_context(
-            const std::shared_ptr<Client> &client,
+            Client *client,
             const std::string &message,
             const std::string &original_message,
-            const std::optional<CommandConstraint> &constraint = std::nullopt);
+            const CommandConstraint *constraint = NULL)
+        {
+            return get_context(client, message, original_message, utils::split(message), constraint);
+        }
+
+        /**
+         * @brief Construct a `Context` from a message which is already split into tokens
+         *
+         * @param client A pointer to the Client object
+         * @param message The message to construct the context from
+         * @param original_message The original message (without environment variables unresolved)
+         * @param tokens The tokens of `message` (see `utils::split`)
+         * @param constraint The constraint to parse the context with, or `NULL`
+         * @return A new context object
+         */
+        static Context get_context(
+            Client *client,
+            const std::string &message,
+            const std::string &original_message,
+            std::vector<std::string> &&tokens,
+            const CommandConstraint *constraint)
+        {
+            Context result(message, original_message, std::move(tokens), client, constraint);
+            if (constraint != NULL)
+            {
+                result._bind();
+            }
+
+            return result;
+        }
     };
 
-    Context Context::get_context(
-        const std::shared_ptr<Client> &client,
-        const std::string &message,
-        const std::string &original_message,
-        const std::optional<CommandConstraint> &constraint)
+    void Context::_bind()
     {
-        const auto tokens = utils::split(message);
-        std::map<std::string, std::vector<std::string>> values;
-        std::set<std::string> present;
+        const auto &constraint = *this->constraint;
 
-        if (constraint.has_value())
+        _present.assign(constraint.slot_count(), false);
+
+        // Walk the tokens and report each value to `emit` as (slot, token index), in command-line order. Only the
+        // first walk validates the command line and marks the present slots.
+        auto walk = [this, &constraint](const bool first, const auto &emit)
         {
-            // Preprocess the tokens: split "-abc" into "-a", "-b", "-c" if all are valid options, etc.
-            // Copy all tokens to a linked list for fast insertion/deletion.
-            std::list<std::string> new_tokens(tokens.begin(), tokens.end());
-            for (auto iter = new_tokens.begin(); iter != new_tokens.end(); iter++)
+            // Mark an option as present, once
+            auto mark = [this, &constraint, first](const Option &option, const std::string_view &token)
             {
-                if (utils::startswith(*iter, "-"))
+                auto slot = constraint.option_slot(&option).index;
+                if (first)
                 {
-                    if (utils::is_valid_long_option(*iter))
+                    if (_present[slot])
                     {
-                        // pass
+                        throw std::invalid_argument(utils::format("\"%s\" was specified twice", std::string(token).c_str()));
                     }
-                    else if (iter->size() > 2)
-                    {
-                        // Split "-abc" into "-a", "-b", "-c" (no checking is done yet)
-                        std::vector<std::string> options;
-                        for (std::size_t i = 1; i < iter->size(); i++)
-                        {
-                            options.push_back(utils::format("-%c", iter->at(i)));
-                        }
 
-                        // Now we perform options checking
-                        bool split = true;
-                        for (auto &option : options)
-                        {
-                            if (!constraint->has_option(option))
-                            {
-                                split = false;
-                                break;
-                            }
-                        }
+                    _present[slot] = true;
+                }
+            };
 
-                        if (split)
-                        {
-                            // All options are valid, insert the split options into the linked list
-#ifdef DEBUG
-                            std::cout << "Split " << *iter << " to " << options << std::endl;
-#endif
+            // Bind the tokens following index `i` to the positional arguments of an option, and return the index of
+            // the last consumed token
+            auto consume = [this, &constraint, &emit](const Option &option, std::size_t i)
+            {
+                const auto base = constraint.option_slot(&option).index + 1;
+                std::size_t position = 0;
+                while (i + 1 < tokens.size() && position < option.positional.size())
+                {
+                    const auto &token = tokens[i + 1];
+                    if (constraint.has_option(token) || constraint.is_flag_group(token))
+                    {
+                        break;
+                    }
 
-                            // Delete the current token e.g. "-abc"
-                            iter = new_tokens.erase(iter);
+                    emit(base + position, i + 1);
+                    _present[base + position] = true;
 
-                            // Insert the split tokens e.g. "-a", "-b", "-c"
-                            iter = new_tokens.insert(iter, options.begin(), options.end());
-                        }
+                    if (!option.positional[position].many)
+                    {
+                        position++;
                     }
-                }
-            }
 
-#ifdef DEBUG
-            std::cout << "Splitted tokens: " << new_tokens << std::endl;
-#endif
-
-            // Vectorize the linked list for fast random access
-            const std::vector<std::string> new_tokens_v(new_tokens.begin(), new_tokens.end());
-            const auto options = constraint->get_options_map();
+                    i++;
+                }
 
-            auto positional_iter = constraint->positional.begin();
-            std::map<std::string, std::vector<PositionalArgument>::const_iterator> options_iter;
-            for (auto &[name, option] : options)
-            {
-                options_iter[name] = option.positional.cbegin();
-            }
+                return i;
+            };
 
-            for (std::size_t i = 1; i < new_tokens_v.size(); i++)
+            std::size_t positional = 0;
+            for (std::size_t i = 1; i < tokens.size(); i++)
             {
-                const auto token = new_tokens_v[i];
+                const auto &token = tokens[i];
 #ifdef DEBUG
-                std::cout << "Parsing at i = " << i << ", token = \"" << token << "\"" << std::endl;
+                if (first)
+                {
+                    std::cout << "Parsing at i = " << i << ", token = \"" << token << "\"" << std::endl;
+                }
 #endif
 
-                const auto option_iter = options.find(token);
-                if (option_iter != options.end())
+                // "-abc" is parsed as "-a -b -c" if all of them are valid options
+                if (constraint.is_flag_group(token))
                 {
-                    bool inserted = true;
-                    for (auto &name : option_iter->second.names())
-                    {
-                        inserted = inserted && present.insert(name).second;
-                    }
-                    if (!inserted)
+#ifdef DEBUG
+                    if (first)
                     {
-                        throw std::invalid_argument(utils::format("\"%s\" was specified twice", token.c_str()));
+                        std::cout << "Split " << token << std::endl;
                     }
-
-                    i++;
-
-                    while (i < new_tokens_v.size() && !constraint->has_option(new_tokens_v[i]) && options_iter[token] != option_iter->second.positional.cend())
+#endif
+                    for (std::size_t j = 1; j < token.size(); j++)
                     {
-                        for (auto &name : option_iter->second.names())
+                        const char name[2] = {'-', token[j]};
+                        const auto &option = *constraint.find_short_option(token[j]);
+                        mark(option, std::string_view(name, 2));
+                        if (j + 1 == token.size())
                         {
-                            auto qualified_name = name + " " + options_iter[name]->name;
-                            values[qualified_name].push_back(new_tokens_v[i]);
-                            present.insert(qualified_name);
-                            if (!options_iter[name]->many)
-                            {
-                                options_iter[name]++;
-                            }
+                            i = consume(option, i);
                         }
-
-                        i++;
                     }
 
-                    if (i < new_tokens_v.size())
-                    {
-                        i--;
-                    }
+                    continue;
+                }
+
+                auto option = constraint.find_option(token);
+                if (option != NULL)
+                {
+                    mark(*option, token);
+                    i = consume(*option, i);
                 }
-                else if (utils::is_valid_short_option(token) || utils::is_valid_long_option(token))
+                else if (!token.empty() && token[0] == '-' && (utils::is_valid_short_option(token) || utils::is_valid_long_option(token)))
                 {
                     throw UnrecognizedOption(token);
                 }
-                else if (positional_iter == constraint->positional.end())
+                else if (positional == constraint.positional.size())
                 {
                     throw TooManyPositionalArguments();
                 }
                 else
                 {
-                    values[positional_iter->name].push_back(token);
-                    present.insert(positional_iter->name);
-                    if (!positional_iter->many)
+                    emit(positional, i);
+                    _present[positional] = true;
+                    if (!constraint.positional[positional].many)
                     {
-                        positional_iter++;
+                        positional++;
                     }
                 }
             }
+        };
 
-#ifdef DEBUG
-            std::cout << "Context obtained:" << std::endl;
-            std::cout << "values = " << values << std::endl;
-            std::cout << "present = " << present << std::endl;
-#endif
+        // Count the values of each slot, then turn the counts into the offset of each slot
+        _offsets.assign(constraint.slot_count() + 1, 0);
+        walk(
+            true,
+            [this](const std::size_t slot, const std::size_t)
+            {
+                _offsets[slot + 1]++;
+            });
 
-            for (auto &argument : constraint->positional)
+        for (std::size_t slot = 0; slot < constraint.slot_count(); slot++)
+        {
+            _offsets[slot + 1] += _offsets[slot];
+        }
+
+        // Fill the values of each slot in command-line order, using its offset as the cursor
+        _values.resize(_offsets.back());
+        walk(
+            false,
+            [this](const std::size_t slot, const std::size_t index)
+            {
+                _values[_offsets[slot]++] = static_cast<std::uint32_t>(index);
+            });
+
+        // Each cursor ended at the offset of the next slot
+        for (std::size_t slot = constraint.slot_count(); slot > 0; slot--)
+        {
+            _offsets[slot] = _offsets[slot - 1];
+        }
+
+        _offsets[0] = 0;
+
+#ifdef DEBUG
+        std::cout << "Context obtained:" << std::endl;
+        for (std::size_t slot = 0; slot < constraint.slot_count(); slot++)
+        {
+            if (_present[slot])
             {
-                if (argument.required && present.count(argument.name) == 0)
+                std::cout << constraint.slot_name(ArgumentSlot{slot}) << " =";
+                for (auto &value : get_all(ArgumentSlot{slot}))
                 {
-                    throw ArgumentMissingError(argument.name);
+                    std::cout << " \"" << value << "\"";
                 }
+                std::cout << std::endl;
+            }
+        }
+#endif
+
+        for (std::size_t slot = 0; slot < constraint.positional.size(); slot++)
+        {
+            if (constraint.positional[slot].required && !_present[slot])
+            {
+                throw ArgumentMissingError(constraint.positional[slot].name);
             }
+        }
 
-            for (auto &[name, option] : options)
+        for (auto &option : constraint.get_options_vector())
+        {
+            const auto base = constraint.option_slot(&option).index;
+            if (option.required && !_present[base])
             {
-                if (option.required || present.count(name) == 1)
-                {
-                    if (present.count(name) == 0)
-                    {
-                        throw ArgumentMissingError(name);
-                    }
+                throw ArgumentMissingError(option.names()[0]);
+            }
 
-                    for (auto &argument : option.positional)
+            if (_present[base])
+            {
+                for (std::size_t j = 0; j < option.positional.size(); j++)
+                {
+                    if (option.positional[j].required && !_present[base + 1 + j])
                     {
-                        auto qualified_name = name + " " + argument.name;
-                        if (argument.required && present.count(qualified_name) == 0)
-                        {
-                            throw ArgumentMissingError(qualified_name);
-                        }
+                        throw ArgumentMissingError(option.qualified_names(0)[j]);
                     }
                 }
             }
         }
-
-        return Context(message, original_message, tokens, values, present, client, constraint);
     }
 }
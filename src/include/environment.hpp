@@ -1,282 +1,1475 @@
 #pragma once
 
+#include "error.hpp"
+#include "export.hpp"
+#include "expression.hpp"
+#include "flat_map.hpp"
+#include "shared_string.hpp"
+#include "snapshot.hpp"
+#include "striped_map.hpp"
 #include "strip.hpp"
 
+/** @brief The maximum number of scopes a variable lookup walks through before falling back to a flattened view */
+#define LITE_SHELL_SCOPE_WALK_LIMIT 4
+
+/** @brief Values at least this long are kept in shared buffers, see `utils::SharedString` */
+#define LITE_SHELL_SHARED_VALUE_SIZE 1024
+
+/** @brief The maximum number of passes `Environment::resolve` makes over a message */
+#define LITE_SHELL_RESOLVE_PASS_LIMIT 256
+
 namespace liteshell
 {
+    /** @brief Integer variables which can be updated concurrently, see `Environment::get_counters` */
+    typedef utils::StripedMap<std::atomic<long long>> SharedCounters;
+
+    /** @brief String variables which can be updated concurrently, see `Environment::get_shared_values` */
+    typedef utils::StripedMap<utils::SharedString> SharedValues;
+
     /**
      * @brief Represent the current environment of the shell.
      *
      * This class mostly contains data about active environment _variables.
+     *
+     * Variables are stored in a chain of scopes. Each scope only records the variables assigned while it is the
+     * innermost one, and refers to the enclosing scope for everything else. Entering a scope is therefore O(1) and
+     * leaving it discards only the variables it changed.
+     *
+     * Each scope is a flat hash table keyed by interned variable names, so looking up a variable from a
+     * `std::string_view` (e.g. a slice of a command line) never allocates.
      */
     class Environment
     {
     private:
-        const boost::regex _var_resolver = boost::regex(R"((?<!\$)\$(?:\{(\w+)\}|(\w+)))");
-        const boost::regex _escape_resolver = boost::regex(R"(\$\$)");
-        std::map<std::string, std::string> _variables;
+        /**
+         * @brief The value of a variable
+         *
+         * Short values are stored inline. Long values are stored in a shared buffer, so copying them (e.g. into a
+         * local scope, or out of the environment with `get_shared`) does not copy their content.
+         */
+        struct _Value
+        {
+            std::string small;
+
+            /** @brief Used instead of `small` if not empty */
+            utils::SharedString large;
+
+            std::string_view view() const
+            {
+                return large.empty() ? std::string_view(small) : large.view();
+            }
+
+            utils::SharedString share() const
+            {
+                return large.empty() ? utils::SharedString(small) : large;
+            }
+
+            void assign(const std::string_view &value)
+            {
+                if (value.size() >= LITE_SHELL_SHARED_VALUE_SIZE)
+                {
+                    _set_large(utils::SharedString(value));
+                }
+                else
+                {
+                    small.assign(value);
+                    large = utils::SharedString();
+                }
+            }
+
+            void assign(const utils::SharedString &value)
+            {
+                if (value.size() >= LITE_SHELL_SHARED_VALUE_SIZE)
+                {
+                    _set_large(value);
+                }
+                else
+                {
+                    assign(value.view());
+                }
+            }
+
+            void append(const std::string_view &value)
+            {
+                if (!large.empty())
+                {
+                    large.append(value);
+                }
+                else if (small.size() + value.size() >= LITE_SHELL_SHARED_VALUE_SIZE)
+                {
+                    std::string combined;
+                    combined.reserve(2 * (small.size() + value.size()));
+                    combined.append(small);
+                    combined.append(value);
+                    _set_large(utils::SharedString(std::move(combined)));
+                }
+                else
+                {
+                    small.append(value);
+                }
+            }
+
+        private:
+            void _set_large(const utils::SharedString &value)
+            {
+                large = value;
+                std::string().swap(small);
+            }
+        };
+
+        /** @brief A single layer of variables, see `Environment::push_scope` */
+        struct _Scope
+        {
+            /** @brief Variables assigned within this scope, keyed by names interned in `names` */
+            utils::FlatStringMap<_Value> variables;
+
+            /** @brief The pool of variable names, to which this scope holds one reference per variable */
+            utils::InternPool *const names;
+
+            /** @brief The enclosing scope, which must not be modified while this scope is alive */
+            std::shared_ptr<const _Scope> parent;
+
+            /** @brief The number of enclosing scopes */
+            std::size_t depth;
+
+            /**
+             * @brief A lazily built, merged view of all enclosing scopes.
+             *
+             * The values point into the enclosing scopes, which stay unchanged while this scope is alive.
+             */
+            mutable std::shared_ptr<const utils::FlatStringMap<const _Value *>> flattened_parent;
+
+            _Scope(const std::shared_ptr<const _Scope> &parent, utils::InternPool *names)
+                : names(names), parent(parent), depth(parent == nullptr ? 0 : parent->depth + 1) {}
+
+            ~_Scope()
+            {
+                variables.for_each(
+                    [this](const std::string_view &name, const _Value &)
+                    {
+                        names->release(name);
+                    });
+            }
+
+            /** @brief Get (and build on first use) the merged view of all enclosing scopes */
+            const utils::FlatStringMap<const _Value *> &get_flattened_parent() const
+            {
+                if (flattened_parent == nullptr)
+                {
+                    auto result = std::make_shared<utils::FlatStringMap<const _Value *>>();
+                    for (auto scope = parent.get(); scope != nullptr; scope = scope->parent.get())
+                    {
+                        scope->variables.for_each(
+                            [&result](const std::string_view &name, const _Value &value)
+                            {
+                                // Inner scopes come first and must not be overwritten
+                                bool inserted;
+                                auto &pointer = result->emplace(name, &inserted);
+                                if (inserted)
+                                {
+                                    pointer = &value;
+                                }
+                            });
+                    }
+
+#ifdef DEBUG
+                    std::cout << "Flattened " << depth << " enclosing scope(s) into " << result->size() << " variable(s)" << std::endl;
+#endif
+                    flattened_parent = result;
+                }
+
+                return *flattened_parent;
+            }
+        };
+
+        /** @brief A variable whose value is computed whenever it is read, see `set_dynamic` */
+        struct _Dynamic
+        {
+            std::function<std::string()> compute;
+
+            /** @brief The last computed value */
+            mutable _Value value;
+        };
+
+        /**
+         * @brief The storage of all variable names, must outlive all scopes
+         *
+         * Scopes release the names of their variables when they are discarded, so names assigned only within
+         * a local scope do not accumulate. Names marked by `export_variable` or `set_dynamic` are kept.
+         */
+        utils::InternPool _names;
+        std::shared_ptr<_Scope> _scope = std::make_shared<_Scope>(nullptr, &_names);
+        utils::FlatStringMap<_Dynamic> _dynamic;
+
+        const std::shared_ptr<SharedCounters> _counters = std::make_shared<SharedCounters>();
+        const std::shared_ptr<SharedValues> _shared_values = std::make_shared<SharedValues>();
+
+        /** @brief The last read value of a counter or a shared value, see `_find` */
+        mutable _Value _shared_value;
+
+        /**
+         * @brief Integer arrays stored by `set_integer_array`, keyed by base name (interned in `_names`)
+         *
+         * The base variable holds the number of elements as usual, but the elements are only stored as variables
+         * once they are written back, see `_write_back`. All these arrays belong to the innermost scope, since
+         * `push_scope` writes back every one of them.
+         */
+        utils::FlatStringMap<std::vector<long long>> _arrays;
+
+        /** @brief Whether each variable is exported to subprocesses */
+        utils::FlatStringMap<bool> _exported;
+        std::size_t _export_count = 0;
+        ExportBlock _export_block;
+
+        /**
+         * @brief Exported variables appended to since the environment block was last read, see `append_value`
+         *
+         * Their entries are synced by `get_export_block`, so building an exported value piece by piece does not
+         * copy the whole value into the block on every append.
+         */
+        std::vector<std::string> _stale_exports;
+        utils::FlatStringMap<bool> _stale;
+
+        /** @brief Compiled forms of recently evaluated expressions */
+        mutable ExpressionCache _expressions, _real_expressions = ExpressionCache(true);
+
+        Environment(const Environment &) = delete;
+        Environment &operator=(const Environment &) = delete;
+
+        /**
+         * @brief Find a variable in the current scope chain
+         *
+         * At most `LITE_SHELL_SCOPE_WALK_LIMIT` scopes are visited one by one, the remaining ones are looked up
+         * through a flattened view.
+         *
+         * @param name The name of the variable
+         * @return A pointer to the value of the variable, or `NULL` if not found
+         */
+        const _Value *_find_assigned(const std::string_view &name) const
+        {
+            const _Scope *scope = _scope.get();
+            for (std::size_t walked = 1; scope != nullptr; walked++)
+            {
+                auto value = scope->variables.find(name);
+                if (value != NULL)
+                {
+                    return value;
+                }
+
+                if (walked == LITE_SHELL_SCOPE_WALK_LIMIT && scope->parent != nullptr)
+                {
+                    auto pointer = scope->get_flattened_parent().find(name);
+                    if (pointer != NULL)
+                    {
+                        return *pointer;
+                    }
+
+                    break;
+                }
+
+                scope = scope->parent.get();
+            }
+
+            return NULL;
+        }
+
+        /**
+         * @brief Find a variable in the current scope chain, then among shared counters, shared values and dynamic
+         * variables
+         *
+         * @param name The name of the variable
+         * @return A pointer to the value of the variable, or `NULL` if not found. The value of a shared variable or a
+         * dynamic variable is valid until it is read again.
+         */
+        const _Value *_find(const std::string_view &name) const
+        {
+            auto value = _find_assigned(name);
+            if (value != NULL)
+            {
+                return value;
+            }
+
+            // Assigned variables shadow shared and dynamic variables
+            auto counter = _counters->find(name);
+            if (counter != NULL)
+            {
+                _shared_value.assign(std::to_string(counter->load()));
+                return &_shared_value;
+            }
+
+            utils::SharedString shared;
+            if (_shared_values->load(name, shared))
+            {
+                _shared_value.assign(shared);
+                return &_shared_value;
+            }
+
+            auto dynamic = _dynamic.find(name);
+            if (dynamic != NULL)
+            {
+                dynamic->value.assign(dynamic->compute());
+                return &dynamic->value;
+            }
+
+            return NULL;
+        }
+
+        /**
+         * @brief Parse a variable reference `$name` or `${name}`
+         *
+         * @param message The message containing the reference
+         * @param position The position right after the `$` sign
+         * @param end Set to the position right after the reference
+         * @return The referenced name, or an empty view if there is no valid reference at `position`
+         */
+        static std::string_view _parse_reference(const std::string_view &message, const std::size_t position, std::size_t &end)
+        {
+            const bool braced = position < message.size() && message[position] == '{';
+            const std::size_t begin = braced ? position + 1 : position;
+
+            end = begin;
+            while (end < message.size() && utils::is_word_character(message[end]))
+            {
+                end++;
+            }
+
+            if (end == begin)
+            {
+                return std::string_view();
+            }
+
+            if (braced)
+            {
+                if (end == message.size() || message[end] != '}')
+                {
+                    return std::string_view();
+                }
+
+                return message.substr(begin, end++ - begin);
+            }
+
+            return message.substr(begin, end - begin);
+        }
+
+        /** @brief Whether a variable is exported to subprocesses */
+        bool _is_exported(const std::string_view &name) const
+        {
+            if (_export_count == 0)
+            {
+                return false;
+            }
+
+            auto exported = _exported.find(name);
+            return exported != NULL && *exported;
+        }
+
+        /** @brief Update the entry of an exported variable in the environment block */
+        void _sync_export(const std::string_view &name)
+        {
+            auto value = _find(name);
+            if (value == NULL)
+            {
+                _export_block.reset(std::string(name));
+            }
+            else
+            {
+                _export_block.set(std::string(name), std::string(value->view()));
+            }
+        }
+
+        /** @brief Invoke `function(i, "name_i")` for each element of an array, without allocating per element */
+        template <typename F>
+        static void _for_each_element(const std::string_view &name, const std::size_t size, const F &function)
+        {
+            std::string element(name);
+            element += '_';
+            element.resize(element.size() + 24);
+
+            const auto prefix = name.size() + 1;
+            for (std::size_t i = 0; i < size; i++)
+            {
+                auto end = std::to_chars(element.data() + prefix, element.data() + element.size(), i).ptr;
+                function(i, std::string_view(element.data(), end - element.data()));
+            }
+        }
+
+        /**
+         * @brief Split the name of an array element such as `arr_12` into the base name and the index
+         *
+         * @param name The name to split
+         * @param base Set to the base name
+         * @param index Set to the index
+         * @return Whether `name` is one of the names produced by `_for_each_element` (e.g. `arr_01` is not)
+         */
+        static bool _split_element(const std::string_view &name, std::string_view &base, std::size_t &index)
+        {
+            const auto separator = name.rfind('_');
+            if (separator == std::string_view::npos)
+            {
+                return false;
+            }
+
+            const auto digits = name.substr(separator + 1);
+            if (digits.empty() || (digits.size() > 1 && digits[0] == '0'))
+            {
+                return false;
+            }
+
+            auto [pointer, error] = std::from_chars(digits.data(), digits.data() + digits.size(), index);
+            if (error != std::errc() || pointer != digits.data() + digits.size())
+            {
+                return false;
+            }
+
+            base = name.substr(0, separator);
+            return true;
+        }
+
+        /**
+         * @brief Store the elements of an array of `_arrays` as separate variables, and forget the array
+         *
+         * @param name The base name of the array
+         */
+        void _write_back(const std::string_view &name)
+        {
+            const std::string base(name);
+            const auto values = std::move(*_arrays.find(base));
+            _arrays.erase(base);
+            _names.release(base);
+
+            _for_each_element(
+                base, values.size(),
+                [this, &values](const std::size_t i, const std::string_view &element)
+                {
+                    char buffer[24];
+                    auto end = std::to_chars(buffer, buffer + sizeof(buffer), values[i]).ptr;
+                    set_value(element, std::string_view(buffer, end - buffer));
+                });
+        }
+
+        /**
+         * @brief Write back the array of `_arrays` that `name` is an element of, before the element is read
+         *
+         * Nothing is parsed unless an array is stored in `_arrays`.
+         *
+         * @param name The name of a variable
+         */
+        void _write_back_element(const std::string_view &name)
+        {
+            if (_arrays.empty())
+            {
+                return;
+            }
+
+            std::string_view base;
+            std::size_t index;
+            if (_split_element(name, base, index))
+            {
+                auto values = _arrays.find(base);
+                if (values != NULL && index < values->size())
+                {
+                    _write_back(base);
+                }
+            }
+        }
+
+        /**
+         * @brief Write back the array of `_arrays` that `name` is the base name or an element of, before `name` is
+         * assigned
+         *
+         * @param name The name of the variable about to be assigned
+         */
+        void _write_back_reference(const std::string_view &name)
+        {
+            if (_arrays.empty())
+            {
+                return;
+            }
+
+            if (_arrays.find(name) != NULL)
+            {
+                _write_back(name);
+            }
+            else
+            {
+                _write_back_element(name);
+            }
+        }
+
+        /** @brief Write back all arrays of `_arrays` */
+        void _write_back_all()
+        {
+            if (_arrays.empty())
+            {
+                return;
+            }
+
+            std::vector<std::string> names;
+            _arrays.for_each(
+                [&names](const std::string_view &name, const std::vector<long long> &)
+                {
+                    names.emplace_back(name);
+                });
+
+            for (auto &name : names)
+            {
+                _write_back(name);
+            }
+        }
+
+        /**
+         * @brief Parse the value of a variable as a number, in place (the stored string is never copied)
+         *
+         * @param name The name of the variable
+         * @param kind The kind of number, used in error messages
+         * @param parse A callable `std::from_chars_result(const char *begin, const char *end, T &result)`
+         * @return The parsed value
+         */
+        template <typename T, typename F>
+        T _parse_number(const std::string_view &name, const char *kind, const F &parse) const
+        {
+            auto value = _find(name);
+            if (value == NULL)
+            {
+                throw std::runtime_error(utils::format("Undefined variable \"%s\"", std::string(name).c_str()));
+            }
+
+            const auto view = value->view();
+            auto begin = view.data(), end = begin + view.size();
+            while (begin != end && *begin == ' ')
+            {
+                begin++;
+            }
+            if (begin != end && *begin == '+')
+            {
+                begin++;
+            }
+
+            T result = 0;
+            auto [pointer, error] = parse(begin, end, result);
+            while (pointer != end && *pointer == ' ')
+            {
+                pointer++;
+            }
+
+            if (begin == end || error != std::errc() || pointer != end)
+            {
+                throw std::runtime_error(utils::format("Variable \"%s\" is not %s", std::string(name).c_str(), kind));
+            }
+
+            return result;
+        }
+
+        /**
+         * @brief Resolve all environment _variables in a message
+         *
+         * References are substituted pass by pass until none is left, so that nested references such as
+         * `${arr_$i}` are resolved from the inside out. Finally, every `$$` is replaced with a literal `$`.
+         *
+         * Referring to an element of an integer array stored by `set_integer_array` writes back the array.
+         *
+         * @tparam S The string type to build the result with
+         * @param message The message to resolve
+         * @param allocator The allocator of the temporary and resulting strings
+         * @return The resolved message
+         * @throw `EnvironmentResolveError` if the references do not converge (e.g. a variable refers to itself)
+         */
+        template <typename S>
+        S _resolve(const std::string_view &message, const typename S::allocator_type &allocator)
+        {
+            S result(message, allocator), buffer(allocator);
+            for (std::size_t pass = 0;; pass++)
+            {
+                if (pass == LITE_SHELL_RESOLVE_PASS_LIMIT)
+                {
+                    throw EnvironmentResolveError("Too many nested variable references");
+                }
+
+                bool substituted = false;
+                buffer.clear();
+                for (std::size_t i = 0; i < result.size(); i++)
+                {
+                    // A "$" preceded by another "$" is escaped
+                    if (result[i] == '$' && (i == 0 || result[i - 1] != '$'))
+                    {
+                        std::size_t end;
+                        auto name = _parse_reference(result, i + 1, end);
+                        if (!name.empty())
+                        {
+                            _write_back_element(name);
+                            auto value = _find(name);
+                            if (value != NULL)
+                            {
+                                buffer += value->view();
+                            }
+
+                            substituted = true;
+                            i = end - 1;
+                            continue;
+                        }
+                    }
+
+                    buffer += result[i];
+                }
+
+                result.swap(buffer);
+                if (!substituted)
+                {
+                    break;
+                }
+            }
+
+            buffer.clear();
+            for (std::size_t i = 0; i < result.size(); i++)
+            {
+                buffer += result[i];
+                if (result[i] == '$' && i + 1 < result.size() && result[i + 1] == '$')
+                {
+                    i++;
+                }
+            }
+
+            return buffer;
+        }
+
+    public:
+        /**
+         * @brief Construct a new `Environment` object
+         */
+        Environment() {}
+
+        /**
+         * @brief Set a value for an environment variable
+         *
+         * The variable is always assigned in the innermost scope.
+         *
+         * @param name The name of the variable
+         * @param value The value of the variable
+         *
+         * @return A pointer to the current environment
+         */
+        Environment *set_value(const std::string_view &name, const std::string_view &value)
+        {
+            _write_back_reference(name);
+
+            auto target = _scope->variables.find(name);
+            if (target == NULL)
+            {
+                target = &_scope->variables.emplace(_names.intern(name));
+            }
+
+            target->assign(value);
+            if (_is_exported(name))
+            {
+                _export_block.set(std::string(name), std::string(target->view()));
+            }
+
+            return this;
+        }
+
+        /**
+         * @brief Set a value for an environment variable, sharing the storage of `value` if it is long
+         * @see `get_shared`
+         *
+         * @param name The name of the variable
+         * @param value The value of the variable
+         *
+         * @return A pointer to the current environment
+         */
+        Environment *set_value(const std::string_view &name, const utils::SharedString &value)
+        {
+            _write_back_reference(name);
+
+            auto target = _scope->variables.find(name);
+            if (target == NULL)
+            {
+                target = &_scope->variables.emplace(_names.intern(name));
+            }
+
+            target->assign(value);
+            if (_is_exported(name))
+            {
+                _export_block.set(std::string(name), std::string(target->view()));
+            }
+
+            return this;
+        }
+
+        /**
+         * @brief Append text to the value of an environment variable in place
+         *
+         * The stored string grows geometrically, so building a value piece by piece takes amortized O(1) per
+         * appended byte. A variable of an enclosing scope is copied into the innermost scope first, as if by
+         * `set_value` (a long value is only copied once it is modified). An undefined variable is treated as empty.
+         *
+         * @param name The name of the variable
+         * @param value The text to append
+         *
+         * @return A pointer to the current environment
+         */
+        Environment *append_value(const std::string_view &name, const std::string_view &value)
+        {
+            _write_back_reference(name);
+
+            auto target = _scope->variables.find(name);
+            if (target == NULL)
+            {
+                // Enclosing scopes are stored in other tables, so this pointer survives the insertion below
+                auto inherited = _find(name);
+                target = &_scope->variables.emplace(_names.intern(name));
+                if (inherited != NULL)
+                {
+                    *target = *inherited;
+                }
+            }
+
+            target->append(value);
+            if (_is_exported(name))
+            {
+                auto stale = _stale.find(name);
+                if (stale == NULL)
+                {
+                    stale = &_stale.emplace(_names.intern(name));
+                }
+
+                if (!*stale)
+                {
+                    *stale = true;
+                    _stale_exports.emplace_back(name);
+                }
+            }
+
+            return this;
+        }
+
+        /**
+         * @brief Define a dynamic variable, whose value is computed only when it is read
+         *
+         * A variable assigned with `set_value` under the same name takes precedence over the dynamic one.
+         *
+         * @param name The name of the variable
+         * @param compute A callable returning the current value of the variable
+         *
+         * @return A pointer to the current environment
+         */
+        Environment *set_dynamic(const std::string_view &name, const std::function<std::string()> &compute)
+        {
+            auto dynamic = _dynamic.find(name);
+            if (dynamic == NULL)
+            {
+                dynamic = &_dynamic.emplace(_names.intern(name));
+            }
+
+            dynamic->compute = compute;
+            return this;
+        }
+
+        /**
+         * @brief Get the shared counters of this environment
+         *
+         * Unlike the environment itself, the returned table is safe to use from multiple threads, e.g. by
+         * worker threads tallying their results. A counter is readable as a variable unless a variable of the
+         * same name is assigned. Background jobs run in separate processes and cannot see it.
+         *
+         * @return The shared counters
+         */
+        const std::shared_ptr<SharedCounters> &get_counters() const
+        {
+            return _counters;
+        }
+
+        /**
+         * @brief Get a shared counter, creating it with value 0 if necessary
+         *
+         * @param name The name of the counter
+         * @return The counter, valid for the lifetime of this environment
+         * @throw `std::runtime_error` if an assigned variable of the same name would shadow the counter
+         */
+        std::atomic<long long> &get_counter(const std::string_view &name)
+        {
+            _write_back_element(name);
+            if (_find_assigned(name) != NULL)
+            {
+                throw std::runtime_error(utils::format("Variable \"%s\" is assigned and cannot be used as a counter", std::string(name).c_str()));
+            }
+
+            if (_shared_values->find(name) != NULL)
+            {
+                throw std::runtime_error(utils::format("Variable \"%s\" is a shared value and cannot be used as a counter", std::string(name).c_str()));
+            }
+
+            return _counters->emplace(name);
+        }
+
+        /**
+         * @brief Get the shared values of this environment
+         *
+         * Like `get_counters`, the returned table is safe to use from multiple threads, as long as its values are
+         * only accessed through `utils::StripedMap::load` and `utils::StripedMap::store`. A shared value is readable
+         * as a variable unless a variable or a counter of the same name exists.
+         *
+         * @return The shared values
+         */
+        const std::shared_ptr<SharedValues> &get_shared_values() const
+        {
+            return _shared_values;
+        }
+
+        /**
+         * @brief Set a shared value, creating it if necessary
+         *
+         * @param name The name of the shared value
+         * @param value The new value
+         * @return A pointer to the current environment
+         * @throw `std::runtime_error` if an assigned variable or a counter of the same name would shadow the value
+         */
+        Environment *set_shared_value(const std::string_view &name, const std::string_view &value)
+        {
+            _write_back_element(name);
+            if (_find_assigned(name) != NULL)
+            {
+                throw std::runtime_error(utils::format("Variable \"%s\" is assigned and cannot be used as a shared value", std::string(name).c_str()));
+            }
+
+            if (_counters->find(name) != NULL)
+            {
+                throw std::runtime_error(utils::format("Variable \"%s\" is a counter and cannot be used as a shared value", std::string(name).c_str()));
+            }
+
+            _shared_values->store(name, utils::SharedString(value));
+            return this;
+        }
+
+        /**
+         * @brief Get the value of an environment variable
+         *
+         * @param name The name of the variable
+         * @return The value of the variable, or an empty string if not found
+         */
+        std::string get_value(const std::string_view &name) const
+        {
+            return std::string(get_view(name));
+        }
+
+        /**
+         * @brief Get the value of an environment variable without copying it
+         *
+         * @param name The name of the variable
+         * @return A view of the value of the variable (or an empty view if not found), valid until the variable is
+         * modified or its scope is left. The value of a shared or dynamic variable is valid until it is read again.
+         */
+        std::string_view get_view(const std::string_view &name) const
+        {
+            auto value = _find(name);
+            return value == NULL ? std::string_view() : value->view();
+        }
+
+        /**
+         * @brief Get the value of an environment variable as a shared string
+         *
+         * A long value is not copied: the result refers to the storage of the variable, and stays valid after the
+         * variable is modified.
+         *
+         * @param name The name of the variable
+         * @return The value of the variable, or an empty string if not found
+         */
+        utils::SharedString get_shared(const std::string_view &name) const
+        {
+            auto value = _find(name);
+            return value == NULL ? utils::SharedString() : value->share();
+        }
+
+        /**
+         * @brief Get a mapping from environment _variables to their values
+         *
+         * The variables are not stored in order, so this method sorts them on demand. Long values are shared
+         * rather than copied, see `get_shared`. Integer arrays are written back first, see `set_integer_array`.
+         *
+         * @return A mapping from environment _variables to their values
+         */
+        std::map<std::string, utils::SharedString> get_values()
+        {
+            _write_back_all();
+
+            std::map<std::string, utils::SharedString> result;
+            _scope->variables.for_each(
+                [&result](const std::string_view &name, const _Value &value)
+                {
+                    result.emplace(name, value.share());
+                });
 
-        Environment(const Environment &) = delete;
-        Environment &operator=(const Environment &) = delete;
+            if (_scope->parent != nullptr)
+            {
+                _scope->get_flattened_parent().for_each(
+                    [&result](const std::string_view &name, const _Value *value)
+                    {
+                        result.emplace(name, value->share());
+                    });
+            }
+
+            _counters->for_each(
+                [&result](const std::string_view &name, const std::atomic<long long> &counter)
+                {
+                    result.emplace(name, utils::SharedString(std::to_string(counter.load())));
+                });
+
+            _shared_values->for_each(
+                [&result](const std::string_view &name, const utils::SharedString &value)
+                {
+                    result.emplace(name, value);
+                });
+
+            _dynamic.for_each(
+                [&result](const std::string_view &name, const _Dynamic &dynamic)
+                {
+                    result.emplace(name, utils::SharedString(dynamic.compute()));
+                });
+
+            return result;
+        }
 
-    public:
         /**
-         * @brief Construct a new `Environment` object
+         * @brief Invoke a function for each visible variable, sorted by name
+         *
+         * Only the names of the matching variables are collected and sorted, values are never copied. Integer
+         * arrays are written back first, see `set_integer_array`.
+         *
+         * @param filter A callable accepting `(std::string_view name)`, returning whether to visit the variable
+         * @param function A callable accepting `(std::string_view name, std::string_view value)`. The value is only
+         * valid during the call.
          */
-        Environment() {}
+        template <typename P, typename F>
+        void for_each_value(const P &filter, const F &function)
+        {
+            _write_back_all();
+
+            std::vector<std::string_view> names;
+            auto collect = [&filter, &names](const std::string_view &name, const auto &)
+            {
+                if (filter(name))
+                {
+                    names.push_back(name);
+                }
+            };
+
+            _scope->variables.for_each(collect);
+            if (_scope->parent != nullptr)
+            {
+                _scope->get_flattened_parent().for_each(collect);
+            }
+
+            _counters->for_each(collect);
+            _shared_values->for_each(collect);
+            _dynamic.for_each(collect);
+
+            std::sort(names.begin(), names.end());
+            names.erase(std::unique(names.begin(), names.end()), names.end());
+
+            for (auto &name : names)
+            {
+                function(name, _find(name)->view());
+            }
+        }
 
         /**
-         * @brief Set a value for an environment variable
+         * @brief Enter a new local scope.
          *
-         * @param name The name of the variable
-         * @param value The value of the variable
+         * Variables assigned after this call are discarded by the matching `pop_scope`, while variables of
+         * the enclosing scopes remain visible. This operation is O(1), apart from writing back the integer arrays
+         * stored in the enclosing scope (see `set_integer_array`).
          *
          * @return A pointer to the current environment
          */
-        Environment *set_value(const std::string &name, const std::string &value)
+        Environment *push_scope()
         {
-            _variables[name] = value;
+            _write_back_all();
+            _scope = std::make_shared<_Scope>(_scope, &_names);
             return this;
         }
 
         /**
-         * @brief Get the value of an environment variable
+         * @brief Leave the innermost local scope and discard all variables assigned within it.
          *
-         * @param name The name of the variable
-         * @return The value of the variable, or an empty string if not found
+         * @return A pointer to the current environment
+         * @throw `std::runtime_error` if there is no local scope to leave
          */
-        std::string get_value(const std::string &name) const
+        Environment *pop_scope()
         {
-            auto iter = _variables.find(name);
-            if (iter == _variables.end())
+            if (_scope->parent == nullptr)
+            {
+                throw std::runtime_error("No local scope to leave");
+            }
+
+            // Only the innermost scope is ever modified, so no other scope can share it
+            auto discarded = _scope;
+            _scope = std::const_pointer_cast<_Scope>(_scope->parent);
+
+            // Arrays not written back were stored within the discarded scope
+            _arrays.for_each(
+                [this](const std::string_view &name, const std::vector<long long> &)
+                {
+                    _names.release(name);
+                });
+            _arrays.clear();
+
+            if (_export_count > 0)
             {
-                return "";
+                discarded->variables.for_each(
+                    [this](const std::string_view &name, const _Value &)
+                    {
+                        if (_is_exported(name))
+                        {
+                            _sync_export(name);
+                        }
+                    });
             }
-            return iter->second;
+
+            return this;
         }
 
         /**
-         * @brief Get a mapping from environment _variables to their values
+         * @brief Get the number of active local scopes
          *
-         * @return A mapping from environment _variables to their values
+         * @return The number of `push_scope` calls without a matching `pop_scope`
          */
-        std::map<std::string, std::string> get_values() const
+        std::size_t scope_depth() const
         {
-            return _variables;
+            return _scope->depth;
         }
 
         /**
-         * @brief Resolve all environment _variables in a message
+         * @brief Mark a variable for export to subprocesses
          *
-         * @param message The message to resolve
-         * @return The resolved message
+         * The current and all future values of the variable are passed to subprocesses until `unexport_variable`
+         * is called. The mark is not affected by local scopes.
+         *
+         * @param name The name of the variable
+         * @return A pointer to the current environment
          */
-        std::string resolve(const std::string &message) const
+        Environment *export_variable(const std::string_view &name)
         {
-            auto result = message;
-            while (true)
+            _write_back_element(name);
+
+            auto exported = _exported.find(name);
+            if (exported == NULL)
             {
-                std::set<std::string> _variables;
-                for (auto begin = result.begin(); begin != result.end(); begin++)
-                {
-                    boost::smatch match;
-                    bool resolved = boost::regex_search(result, match, _var_resolver);
-                    if (resolved)
-                    {
-                        auto group_1 = utils::strip(match.str(1)), group_2 = utils::strip(match.str(2));
-                        _variables.insert(group_1.empty() ? group_2 : group_1);
-                    }
-                }
+                exported = &_exported.emplace(_names.intern(name));
+            }
 
-                if (_variables.empty())
-                {
-                    break;
-                }
-                else
+            if (!*exported)
+            {
+                *exported = true;
+                _export_count++;
+            }
+
+            _sync_export(name);
+            return this;
+        }
+
+        /**
+         * @brief Stop exporting a variable to subprocesses
+         *
+         * @param name The name of the variable
+         * @return A pointer to the current environment
+         */
+        Environment *unexport_variable(const std::string_view &name)
+        {
+            if (_is_exported(name))
+            {
+                *_exported.find(name) = false;
+                _export_count--;
+                _export_block.reset(std::string(name));
+            }
+
+            return this;
+        }
+
+        /**
+         * @brief Get the names of all exported variables
+         *
+         * @return The sorted names of all exported variables
+         */
+        std::vector<std::string> get_exported() const
+        {
+            std::vector<std::string> result;
+            _exported.for_each(
+                [&result](const std::string_view &name, const bool exported)
                 {
-                    for (auto &variable : _variables)
+                    if (exported)
                     {
-                        auto pattern = boost::regex(utils::format("(?<!\\$)\\$(?:\\{%s\\}|%s)", variable.c_str(), variable.c_str()));
-                        result = boost::regex_replace(result, pattern, utils::regex_escape(get_value(variable)));
+                        result.emplace_back(name);
                     }
-                }
-            }
+                });
 
-            result = boost::regex_replace(result, _escape_resolver, "$");
+            std::sort(result.begin(), result.end());
             return result;
         }
 
         /**
-         * @brief Evaluate a mathematical expression
+         * @brief Get the environment block for subprocesses
          *
-         * @param expression The expression to evaluate
-         * @return The result of the evaluation
+         * @return A pointer to the environment block (see `ExportBlock::data`), or `NULL` if no variable is
+         * exported, in which case subprocesses simply inherit the environment of the shell
          */
-        long long eval_ll(const std::string &expression) const
+        const wchar_t *get_export_block()
         {
-            for (auto &c : expression)
+            for (auto &name : _stale_exports)
             {
-                if (!utils::is_math_symbol(c))
+                *_stale.find(name) = false;
+                if (_is_exported(name))
                 {
-                    throw std::runtime_error(utils::format("Unrecognized symbol: %c", c));
+                    _sync_export(name);
                 }
             }
 
-            // https://cp-algorithms.com/string/expression_parsing.html
+            _stale_exports.clear();
+            return _export_count == 0 ? NULL : _export_block.data();
+        }
 
-            std::stack<long long> st;
-            std::stack<char> op;
+        /**
+         * @brief Save all visible variables to a snapshot file
+         *
+         * Shared counters, shared values and dynamic variables are not saved. Export marks are saved along with the variables.
+         * Integer arrays are written back first, see `set_integer_array`.
+         *
+         * @param path The path to the snapshot file
+         * @return The number of saved variables
+         */
+        std::size_t save_snapshot(const std::string &path)
+        {
+            _write_back_all();
 
-            auto priority = [](char op)
+            snapshot::Writer writer;
+            std::size_t count = 0;
+            auto add = [this, &writer, &count](const std::string_view &name, const _Value &value)
             {
-                if (op < 0) // unary operator
-                    return 3;
-                if (op == '+' || op == '-')
-                    return 1;
-                if (op == '*' || op == '/' || op == '%')
-                    return 2;
-
-                return -1;
+                writer.add(name, value.view(), _is_exported(name) ? snapshot::EXPORTED : 0);
+                count++;
             };
 
-            auto process_op = [&st](char op)
+            _scope->variables.for_each(add);
+            if (_scope->parent != nullptr)
             {
-                if (op < 0)
+                _scope->get_flattened_parent().for_each(
+                    [this, &add](const std::string_view &name, const _Value *value)
+                    {
+                        // Shadowed by the innermost scope
+                        if (_scope->variables.find(name) == NULL)
+                        {
+                            add(name, *value);
+                        }
+                    });
+            }
+
+            writer.write(path);
+            return count;
+        }
+
+        /**
+         * @brief Load variables from a snapshot file (see `save_snapshot`) into the innermost scope
+         *
+         * The whole file is validated before any variable is assigned, so a corrupted snapshot leaves the
+         * environment unchanged. The names are interned as a single batch (see `utils::InternPool::intern_all`)
+         * and the records are inserted directly into the scope table, sized for all of them up front.
+         *
+         * @param path The path to the snapshot file
+         * @return The number of loaded variables
+         */
+        std::size_t load_snapshot(const std::string &path)
+        {
+            snapshot::Reader reader(path);
+            _write_back_all();
+
+            std::vector<std::string_view> names;
+            names.reserve(reader.size());
+            reader.for_each(
+                [&names](const std::string_view &name, const std::string_view &, const std::uint32_t)
+                {
+                    names.push_back(name);
+                });
+
+            const auto interned = _names.intern_all(names);
+
+            auto &variables = _scope->variables;
+            variables.reserve(variables.size() + reader.size());
+
+            std::size_t i = 0;
+            reader.for_each(
+                [this, &interned, &variables, &i](const std::string_view &name, const std::string_view &value, const std::uint32_t flags)
                 {
-                    if (st.empty())
+                    bool inserted;
+                    auto &target = variables.emplace(interned[i], &inserted);
+                    if (!inserted)
                     {
-                        throw std::runtime_error("Invalid expression at unary operator");
+                        // The scope already holds a reference to this name
+                        _names.release(interned[i]);
                     }
 
-                    long long l = st.top();
-                    st.pop();
-                    switch (-op)
+                    target.assign(value);
+                    if (flags & snapshot::EXPORTED)
                     {
-                    case '+':
-                        st.push(l);
-                        break;
-                    case '-':
-                        st.push(-l);
-                        break;
-                    default:
-                        throw std::runtime_error(utils::format("Invalid expression - unknown unary operator %c", op));
+                        export_variable(name);
                     }
-                }
-                else
-                {
-                    if (st.empty())
+                    else if (_is_exported(name))
                     {
-                        throw std::runtime_error("Invalid expression at binary operator");
+                        _sync_export(name);
                     }
-                    long long r = st.top();
-                    st.pop();
 
-                    if (st.empty())
-                    {
-                        throw std::runtime_error("Invalid expression at binary operator");
-                    }
-                    long long l = st.top();
-                    st.pop();
+                    i++;
+                });
 
-                    switch (op)
-                    {
-                    case '+':
-                        st.push(l + r);
-                        break;
-                    case '-':
-                        st.push(l - r);
-                        break;
-                    case '*':
-                        st.push(l * r);
-                        break;
-                    case '/':
-                        if (r == 0)
-                        {
-                            throw std::runtime_error("Invalid expression - division by zero");
-                        }
+            return reader.size();
+        }
 
-                        st.push(l / r);
-                        break;
-                    case '%':
-                        if (r == 0)
-                        {
-                            throw std::runtime_error("Invalid expression - division by zero");
-                        }
+        /**
+         * @brief Resolve all environment variables in a message
+         * @see `Environment::_resolve`
+         *
+         * @param message The message to resolve
+         * @return The resolved message
+         */
+        std::string resolve(const std::string_view &message)
+        {
+            return _resolve<std::string>(message, {});
+        }
 
-                        st.push(l % r);
-                        break;
-                    default:
-                        throw std::runtime_error(utils::format("Invalid expression - unknown binary operator %c", op));
-                    }
-                }
-            };
+        /**
+         * @brief Resolve all environment variables in a message, allocating the temporaries and the result from a
+         * memory resource (e.g. a `utils::Arena`)
+         * @see `Environment::_resolve`
+         *
+         * @param message The message to resolve
+         * @param resource The memory resource to allocate from
+         * @return The resolved message
+         */
+        std::pmr::string resolve(const std::string_view &message, std::pmr::memory_resource *resource)
+        {
+            return _resolve<std::pmr::string>(message, resource);
+        }
 
-            bool may_be_unary = true;
-            for (std::size_t i = 0; i < expression.size(); i++)
-            {
-                if (expression[i] == ' ')
+        /**
+         * @brief Get the value of a variable as an integer
+         *
+         * @param name The name of the variable
+         * @return The integer value of the variable
+         */
+        long long get_integer(const std::string_view &name) const
+        {
+            return _parse_number<long long>(
+                name, "an integer",
+                [](const char *begin, const char *end, long long &result)
                 {
-                    continue;
-                }
+                    return std::from_chars(begin, end, result);
+                });
+        }
+
+        /**
+         * @brief Get the value of a variable as a floating-point number
+         *
+         * @param name The name of the variable
+         * @return The floating-point value of the variable
+         */
+        double get_real(const std::string_view &name) const
+        {
+            return _parse_number<double>(
+                name, "a number",
+                [](const char *begin, const char *end, double &result)
+                {
+                    return std::from_chars(begin, end, result, std::chars_format::general);
+                });
+        }
 
-                if (expression[i] == '(')
+        /**
+         * @brief Read an array, stored as by the `array` command (`name` holds the number of elements, `name_0`,
+         * `name_1`, ... hold the elements)
+         *
+         * @param name The base name of the array
+         * @return The elements of the array
+         */
+        std::vector<std::string> get_array(const std::string_view &name) const
+        {
+            auto values = _arrays.find(name);
+            if (values != NULL)
+            {
+                std::vector<std::string> result;
+                result.reserve(values->size());
+                for (auto value : *values)
                 {
-                    op.push('(');
-                    may_be_unary = true;
+                    result.push_back(std::to_string(value));
                 }
-                else if (expression[i] == ')')
+
+                return result;
+            }
+
+            const auto size = get_integer(name);
+            if (size < 0)
+            {
+                throw std::runtime_error(utils::format("Invalid array size %lld of \"%s\"", size, std::string(name).c_str()));
+            }
+
+            std::vector<std::string> result(size);
+            _for_each_element(
+                name, size,
+                [this, &result](const std::size_t i, const std::string_view &element)
                 {
-                    while (op.top() != '(')
-                    {
-                        process_op(op.top());
-                        op.pop();
+                    result[i] = get_value(element);
+                });
 
-                        if (op.empty())
-                        {
-                            throw std::runtime_error("Invalid expression - missing bracket");
-                        }
-                    }
+            return result;
+        }
 
-                    op.pop();
-                    may_be_unary = false;
-                }
-                else if (expression[i] == '+' || expression[i] == '-' || expression[i] == '*' || expression[i] == '/' || expression[i] == '%')
+        /**
+         * @brief Store an array in the format of the `array` command
+         * @see `get_array`
+         *
+         * @param name The base name of the array
+         * @param values The elements of the array
+         * @return A pointer to the current environment
+         */
+        Environment *set_array(const std::string_view &name, const std::vector<std::string_view> &values)
+        {
+            set_value(name, std::to_string(values.size()));
+            _for_each_element(
+                name, values.size(),
+                [this, &values](const std::size_t i, const std::string_view &element)
                 {
-                    char cur_op = expression[i];
-                    if (may_be_unary && (cur_op == '+' || cur_op == '-'))
-                    {
-                        cur_op = -cur_op;
-                    }
-                    while (!op.empty() && ((cur_op >= 0 && priority(op.top()) >= priority(cur_op)) ||
-                                           (cur_op < 0 && priority(op.top()) > priority(cur_op))))
-                    {
-                        process_op(op.top());
-                        op.pop();
-                    }
-                    op.push(cur_op);
-                    may_be_unary = true;
-                }
-                else
+                    set_value(element, values[i]);
+                });
+
+            return this;
+        }
+
+        /**
+         * @brief Read an array of integers
+         * @see `get_array`
+         *
+         * @param name The base name of the array
+         * @return The elements of the array, in contiguous memory
+         */
+        std::vector<long long> get_integer_array(const std::string_view &name) const
+        {
+            auto values = _arrays.find(name);
+            if (values != NULL)
+            {
+                return *values;
+            }
+
+            const auto size = get_integer(name);
+            if (size < 0)
+            {
+                throw std::runtime_error(utils::format("Invalid array size %lld of \"%s\"", size, std::string(name).c_str()));
+            }
+
+            std::vector<long long> result(size);
+            _for_each_element(
+                name, size,
+                [this, &result](const std::size_t i, const std::string_view &element)
                 {
-                    long long number = 0;
-                    while (i < expression.size() && expression[i] >= '0' && expression[i] <= '9')
-                    {
-                        number = number * 10 + expression[i++] - '0';
-                    }
-                    i--;
+                    result[i] = get_integer(element);
+                });
 
-                    st.push(number);
-                    may_be_unary = false;
-                }
+            return result;
+        }
+
+        /**
+         * @brief Store an array of integers
+         * @see `set_array`
+         *
+         * Only the base variable is assigned right away. The elements are kept in a separate table of contiguous
+         * arrays, so storing and reading back the whole array (see `get_integer_array`) does not touch a variable
+         * per element, and lookups of other variables never consult that table. The elements are written back as
+         * separate variables when one of them is referred to (e.g. `${name_0}`), when `name` or an element is
+         * assigned, or when the variables are listed, saved, exported or a scope is entered.
+         *
+         * @param name The base name of the array
+         * @param values The elements of the array
+         * @return A pointer to the current environment
+         */
+        Environment *set_integer_array(const std::string_view &name, std::vector<long long> &&values)
+        {
+            // A previous array under this name is replaced outright unless some of its elements would outlive it
+            auto previous = _arrays.find(name);
+            if (previous != NULL && previous->size() <= values.size())
+            {
+                _arrays.erase(name);
+                _names.release(name);
+            }
+
+            set_value(name, std::to_string(values.size()));
+            _arrays.emplace(_names.intern(name)) = std::move(values);
+
+            // Exported elements must be in the environment block of subprocesses
+            bool exported = false;
+            if (_export_count > 0)
+            {
+                const auto size = _arrays.find(name)->size();
+                _exported.for_each(
+                    [&name, &size, &exported](const std::string_view &element, const bool marked)
+                    {
+                        std::string_view base;
+                        std::size_t index;
+                        if (marked && _split_element(element, base, index) && base == name && index < size)
+                        {
+                            exported = true;
+                        }
+                    });
             }
 
-            while (!op.empty())
+            if (exported)
             {
-                process_op(op.top());
-                op.pop();
+                _write_back(name);
             }
 
-            return st.empty() ? 0 : st.top();
+            return this;
+        }
+
+        /**
+         * @brief Store an array of integers
+         * @see `set_integer_array`
+         *
+         * @param name The base name of the array
+         * @param values The elements of the array
+         * @return A pointer to the current environment
+         */
+        Environment *set_integer_array(const std::string_view &name, const std::vector<long long> &values)
+        {
+            return set_integer_array(name, std::vector<long long>(values));
+        }
+
+        /**
+         * @brief Evaluate a mathematical expression
+         *
+         * Bare identifiers in the expression (e.g. `div * div`) are read from the variables of this environment,
+         * see `get_integer`. Referring to an element of an integer array writes back the array, as in `resolve`.
+         *
+         * @param expression The expression to evaluate
+         * @return The result of the evaluation
+         */
+        long long eval_ll(const std::string_view &expression)
+        {
+            return _expressions.get(expression).evaluate(
+                [this](const std::string_view &name)
+                {
+                    _write_back_element(name);
+                    return get_integer(name);
+                });
+        }
+
+        /**
+         * @brief Evaluate a mathematical expression in floating-point mode
+         * @see `eval_ll`
+         *
+         * @param expression The expression to evaluate
+         * @return The result of the evaluation
+         */
+        double eval_d(const std::string_view &expression)
+        {
+            return _real_expressions.get(expression).evaluate<double>(
+                [this](const std::string_view &name)
+                {
+                    _write_back_element(name);
+                    return get_real(name);
+                });
         }
     };
 }
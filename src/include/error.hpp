@@ -45,12 +45,60 @@ namespace liteshell
         EnvironmentResolveError(const std::string &message) : EnvironmentException(message) {}
     };
 
-    /** @brief Exception thrown when a command couldn't be found */
+    /**
+     * @brief Exception thrown when a command couldn't be found
+     *
+     * The suggestion is only searched for when the error is displayed, i.e. on the first call to `what()`
+     */
     class CommandNotFound : public LiteShellException
     {
+    private:
+        const std::string _name;
+        const std::function<std::string()> _suggest;
+        mutable std::optional<std::string> _what;
+
     public:
-        CommandNotFound(const std::string &name, const std::string &suggestion)
-            : LiteShellException(utils::format("Command \"%s\" not found. Did you mean \"%s\"?", name.c_str(), suggestion.c_str())) {}
+        /**
+         * @brief Format the message of this error
+         *
+         * @param name The name of the command
+         * @param suggestion The name of the closest command, if any
+         * @return The error message
+         */
+        static std::string format(const std::string &name, const std::optional<std::string> &suggestion = std::nullopt)
+        {
+            auto result = utils::format("Command \"%s\" not found", name.c_str());
+            if (suggestion.has_value())
+            {
+                result += utils::format(". Did you mean \"%s\"?", suggestion->c_str());
+            }
+
+            return result;
+        }
+
+        /**
+         * @param name The name of the command
+         * @param suggest A callable returning the name of the closest command
+         */
+        CommandNotFound(const std::string &name, const std::function<std::string()> &suggest)
+            : LiteShellException(format(name)), _name(name), _suggest(suggest) {}
+
+        const char *what() const noexcept
+        {
+            if (!_what.has_value())
+            {
+                try
+                {
+                    _what = format(_name, _suggest());
+                }
+                catch (std::exception &)
+                {
+                    return message.c_str();
+                }
+            }
+
+            return _what->c_str();
+        }
     };
 
     /** @brief Exceptions regarding context parsing */
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "converter.hpp"
+#include "utils.hpp"
+
+namespace liteshell
+{
+    /**
+     * @brief The environment block passed to subprocesses.
+     *
+     * The block starts as a copy of the environment inherited by the shell process. Each exported shell variable
+     * adds or overrides one entry. The block is kept assembled at all times: every entry remembers its offset in
+     * the block, and a change only splices that entry (in place if its length is unchanged). Spawning a subprocess
+     * after changing one exported variable therefore never re-serializes the whole environment.
+     *
+     * @see https://learn.microsoft.com/en-us/windows/win32/procthread/changing-environment-variables
+     */
+    class ExportBlock
+    {
+    private:
+        /** @brief Environment variable names are case-insensitive, and the block must be sorted accordingly */
+        struct _case_insensitive_less
+        {
+            bool operator()(const std::wstring &first, const std::wstring &second) const
+            {
+                return std::lexicographical_compare(
+                    first.begin(), first.end(),
+                    second.begin(), second.end(),
+                    [](wchar_t a, wchar_t b)
+                    {
+                        return towupper(a) < towupper(b);
+                    });
+            }
+        };
+
+        /** @brief An entry `NAME=value` of the block */
+        struct _Entry
+        {
+            std::wstring name, text;
+
+            /** @brief The position of `text` in the block, followed by its null terminator */
+            std::size_t offset;
+        };
+
+        /** @brief Entries `NAME=value` inherited from the shell process, keyed by name */
+        std::map<std::wstring, std::wstring, _case_insensitive_less> _inherited;
+
+        /**
+         * @brief Entries of the block, sorted by name (which is the block order)
+         *
+         * A sorted vector rather than a map: shifting the offsets after a resized entry is then a linear pass
+         * over contiguous memory.
+         */
+        std::vector<_Entry> _entries;
+
+        /** @brief The entries, each followed by a null character, then a final null character */
+        std::vector<wchar_t> _block;
+
+        ExportBlock(const ExportBlock &) = delete;
+        ExportBlock &operator=(const ExportBlock &) = delete;
+
+        /** @brief Update the offsets of the entries from `iter` onwards after their text moved by `delta` characters */
+        void _shift(std::vector<_Entry>::iterator iter, const std::ptrdiff_t delta)
+        {
+            for (; iter != _entries.end(); iter++)
+            {
+                iter->offset += delta;
+            }
+        }
+
+        /** @brief Find the first entry whose name is not less than `name` */
+        std::vector<_Entry>::iterator _lower_bound(const std::wstring &name)
+        {
+            return std::lower_bound(
+                _entries.begin(), _entries.end(), name,
+                [](const _Entry &entry, const std::wstring &name)
+                {
+                    return _case_insensitive_less()(entry.name, name);
+                });
+        }
+
+        /** @brief Whether `iter` (from `_lower_bound(name)`) points to the entry of `name` */
+        bool _matches(const std::vector<_Entry>::iterator &iter, const std::wstring &name) const
+        {
+            return iter != _entries.end() && !_case_insensitive_less()(name, iter->name);
+        }
+
+        /** @brief Add a new entry or replace the text of an existing one, splicing only that entry */
+        void _assign(const std::wstring &name, std::wstring &&text)
+        {
+            auto iter = _lower_bound(name);
+            if (!_matches(iter, name))
+            {
+                const auto offset = iter == _entries.end() ? _block.size() - 1 : iter->offset;
+                iter = _entries.insert(iter, _Entry{name, std::move(text), offset});
+
+                auto position = _block.insert(_block.begin() + offset, iter->text.begin(), iter->text.end());
+                _block.insert(position + iter->text.size(), L'\0');
+                _shift(std::next(iter), iter->text.size() + 1);
+                return;
+            }
+
+            auto &entry = *iter;
+            const auto begin = _block.begin() + entry.offset;
+            if (text.size() == entry.text.size())
+            {
+                std::copy(text.begin(), text.end(), begin);
+            }
+            else
+            {
+                const auto common = std::min(text.size(), entry.text.size());
+                std::copy(text.begin(), text.begin() + common, begin);
+                if (text.size() > entry.text.size())
+                {
+                    _block.insert(begin + common, text.begin() + common, text.end());
+                }
+                else
+                {
+                    _block.erase(begin + common, begin + entry.text.size());
+                }
+
+                _shift(std::next(iter), (std::ptrdiff_t)text.size() - (std::ptrdiff_t)entry.text.size());
+            }
+
+            entry.text = std::move(text);
+        }
+
+        /** @brief Remove an entry if it exists */
+        void _erase(const std::wstring &name)
+        {
+            auto iter = _lower_bound(name);
+            if (_matches(iter, name))
+            {
+                const auto begin = _block.begin() + iter->offset;
+                const auto size = iter->text.size() + 1;
+                _block.erase(begin, begin + size);
+                _shift(_entries.erase(iter), -(std::ptrdiff_t)size);
+            }
+        }
+
+    public:
+        /** @brief Construct a new `ExportBlock` from the environment of the current process */
+        ExportBlock()
+        {
+            auto strings = GetEnvironmentStringsW();
+            if (strings == NULL)
+            {
+                throw std::runtime_error(utils::last_error("GetEnvironmentStringsW ERROR"));
+            }
+
+            for (auto entry = strings; *entry != L'\0'; entry += wcslen(entry) + 1)
+            {
+                // Names of hidden entries such as "=C:=C:\\" start with "="
+                auto separator = wcschr(entry + 1, L'=');
+                if (separator != NULL)
+                {
+                    _inherited.emplace(std::wstring(entry, separator), std::wstring(entry));
+                }
+            }
+
+            FreeEnvironmentStringsW(strings);
+
+            for (auto &[name, text] : _inherited)
+            {
+                _entries.push_back(_Entry{name, text, _block.size()});
+                _block.insert(_block.end(), text.begin(), text.end());
+                _block.push_back(L'\0');
+            }
+
+            _block.push_back(L'\0');
+        }
+
+        /**
+         * @brief Add or override an entry of the block
+         *
+         * @param name The name of the variable
+         * @param value The value of the variable
+         */
+        void set(const std::string &name, const std::string &value)
+        {
+            auto wname = utils::utf_convert(name);
+            _assign(wname, wname + L"=" + utils::utf_convert(value));
+        }
+
+        /**
+         * @brief Restore an entry to the value inherited from the shell process, or remove it
+         *
+         * @param name The name of the variable
+         */
+        void reset(const std::string &name)
+        {
+            auto wname = utils::utf_convert(name);
+            auto iter = _inherited.find(wname);
+            if (iter == _inherited.end())
+            {
+                _erase(wname);
+            }
+            else
+            {
+                _assign(wname, std::wstring(iter->second));
+            }
+        }
+
+        /**
+         * @brief Get the environment block, suitable for `CreateProcessW` with `CREATE_UNICODE_ENVIRONMENT`
+         *
+         * @return A pointer to the block, valid until the next modification
+         */
+        const wchar_t *data() const
+        {
+            return _block.data();
+        }
+    };
+}
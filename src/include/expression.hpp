@@ -0,0 +1,728 @@
+#pragma once
+
+#include "utils.hpp"
+
+/** @brief The maximum number of operands an expression may keep on the evaluation stack at once */
+#define LITE_SHELL_EXPRESSION_STACK_LIMIT 128
+
+/** @brief The maximum nesting level of brackets and unary operators in an expression */
+#define LITE_SHELL_EXPRESSION_NESTING_LIMIT 256
+
+/** @brief The number of compiled expressions kept by `ExpressionCache` */
+#define LITE_SHELL_EXPRESSION_CACHE_SIZE 256
+
+namespace liteshell
+{
+    /**
+     * @brief A mathematical expression compiled to postfix form.
+     *
+     * Compilation validates the expression once (symbols, brackets and operand counts), so evaluating a compiled
+     * expression only has to detect errors that depend on the operand values, e.g. division by zero. Evaluation
+     * runs on a fixed-size stack and never allocates.
+     *
+     * Operands are either integer literals or bare identifiers such as `div * div`. Identifiers are kept by name
+     * in the compiled program and looked up on every evaluation, so the same compiled expression can be reused
+     * while the variables change.
+     *
+     * Supported operators, from the lowest to the highest precedence (same as C):
+     * - `?:` (right-associative)
+     * - `||`, `&&` (short-circuiting, the result is 0 or 1)
+     * - `|`, `^`, `&`
+     * - `==`, `!=`, then `<`, `>`, `<=`, `>=` (the result is 0 or 1)
+     * - `<<`, `>>`
+     * - `+`, `-`, then `*`, `/`, `%`
+     * - unary `+`, `-`, `!`, `~`
+     *
+     * An expression is compiled either in integer mode (`long long`) or in floating-point mode (`double`). In
+     * floating-point mode, literals may contain a fraction and an exponent (e.g. `1.5e3`), `%` computes the
+     * floating-point remainder and the bitwise operators are not allowed.
+     */
+    class Expression
+    {
+    private:
+        enum _Opcode : char
+        {
+            _PUSH,
+            _LOAD,
+            _NEGATE,
+            _NOT,
+            _BITWISE_NOT,
+            _ADD,
+            _SUBTRACT,
+            _MULTIPLY,
+            _DIVIDE,
+            _MODULO,
+            _SHIFT_LEFT,
+            _SHIFT_RIGHT,
+            _LESS,
+            _GREATER,
+            _LESS_EQUAL,
+            _GREATER_EQUAL,
+            _EQUAL,
+            _NOT_EQUAL,
+            _BITWISE_AND,
+            _BITWISE_XOR,
+            _BITWISE_OR,
+            _TO_BOOLEAN,
+            _JUMP,              // jump to the operand
+            _JUMP_IF_ZERO,      // pop the top, jump to the operand if it is 0
+            _AND_JUMP_IF_ZERO,  // jump to the operand if the top is 0, pop it otherwise
+            _OR_JUMP_IF_NONZERO // replace the top with 1 and jump to the operand if it is not 0, pop it otherwise
+        };
+
+        struct _Instruction
+        {
+            _Opcode opcode;
+            long long operand;
+
+            /** @brief The value of a `_PUSH` instruction in floating-point mode */
+            double constant;
+        };
+
+        struct _BinaryOperator
+        {
+            _Opcode opcode;
+            int precedence;
+            std::size_t length;
+        };
+
+        std::vector<_Instruction> _program;
+        bool _floating = false;
+
+        /** @brief The identifiers referenced by `_LOAD` instructions, indexed by their operand */
+        std::vector<std::string> _names;
+
+        /** @brief A recursive descent parser emitting the postfix program of an expression */
+        class _Compiler
+        {
+        private:
+            const std::string_view _expression;
+            std::size_t _position = 0, _depth = 0, _nesting = 0;
+            Expression &_result;
+
+            void _skip_spaces()
+            {
+                while (_position < _expression.size() && _expression[_position] == ' ')
+                {
+                    _position++;
+                }
+            }
+
+            /** @brief Consume `symbol` if the expression continues with it */
+            bool _accept(const std::string_view &symbol)
+            {
+                _skip_spaces();
+                if (_expression.substr(_position, symbol.size()) == symbol)
+                {
+                    _position += symbol.size();
+                    return true;
+                }
+
+                return false;
+            }
+
+            std::size_t _emit(const _Opcode opcode, const long long operand = 0, const double constant = 0)
+            {
+                _result._program.push_back({opcode, operand, constant});
+                return _result._program.size() - 1;
+            }
+
+            /** @brief Point a previously emitted jump to the next instruction */
+            void _patch(const std::size_t jump)
+            {
+                _result._program[jump].operand = _result._program.size();
+            }
+
+            void _push_operand(const _Opcode opcode, const long long operand, const double constant = 0)
+            {
+                _emit(opcode, operand, constant);
+                if (++_depth > LITE_SHELL_EXPRESSION_STACK_LIMIT)
+                {
+                    throw std::runtime_error("Invalid expression - too many nested operands");
+                }
+            }
+
+            void _require_integers(const std::string_view &op) const
+            {
+                if (_result._floating)
+                {
+                    throw std::runtime_error(utils::format("Invalid expression - operator %s requires integers", std::string(op).c_str()));
+                }
+            }
+
+            void _enter()
+            {
+                if (++_nesting > LITE_SHELL_EXPRESSION_NESTING_LIMIT)
+                {
+                    throw std::runtime_error("Invalid expression - too deeply nested");
+                }
+            }
+
+            void _primary()
+            {
+                _skip_spaces();
+                if (_position == _expression.size())
+                {
+                    throw std::runtime_error("Invalid expression - missing operand");
+                }
+
+                const char c = _expression[_position];
+                if (c == '(')
+                {
+                    _position++;
+                    _ternary();
+                    if (!_accept(")"))
+                    {
+                        throw std::runtime_error("Invalid expression - missing bracket");
+                    }
+                }
+                else if (_result._floating && ((c >= '0' && c <= '9') || c == '.'))
+                {
+                    double number = 0;
+                    auto begin = _expression.data() + _position, end = _expression.data() + _expression.size();
+                    auto [pointer, error] = std::from_chars(begin, end, number, std::chars_format::general);
+                    if (error == std::errc::invalid_argument)
+                    {
+                        throw std::runtime_error(utils::format("Invalid expression - unexpected symbol %c", c));
+                    }
+                    if (error == std::errc::result_out_of_range)
+                    {
+                        throw std::runtime_error("Invalid expression - number is out of range");
+                    }
+
+                    _position += pointer - begin;
+                    if (_position < _expression.size() && (utils::is_word_character(_expression[_position]) || _expression[_position] == '.'))
+                    {
+                        throw std::runtime_error(utils::format("Invalid expression - unexpected symbol %c after a number", _expression[_position]));
+                    }
+
+                    _push_operand(_PUSH, 0, number);
+                }
+                else if (c >= '0' && c <= '9')
+                {
+                    long long number = 0;
+                    while (_position < _expression.size() && _expression[_position] >= '0' && _expression[_position] <= '9')
+                    {
+                        // Accumulating in long long rejects anything above LLONG_MAX
+                        if (__builtin_mul_overflow(number, 10, &number) || __builtin_add_overflow(number, _expression[_position++] - '0', &number))
+                        {
+                            throw std::runtime_error("Invalid expression - integer overflow in literal");
+                        }
+                    }
+
+                    if (_position < _expression.size() && utils::is_word_character(_expression[_position]))
+                    {
+                        throw std::runtime_error(utils::format("Invalid expression - unexpected symbol %c after a number", _expression[_position]));
+                    }
+
+                    _push_operand(_PUSH, number);
+                }
+                else if (utils::is_word_character(c))
+                {
+                    auto start = _position;
+                    while (_position < _expression.size() && utils::is_word_character(_expression[_position]))
+                    {
+                        _position++;
+                    }
+
+                    auto name = _expression.substr(start, _position - start);
+                    auto &names = _result._names;
+                    auto iter = std::find(names.begin(), names.end(), name);
+                    if (iter == names.end())
+                    {
+                        iter = names.emplace(names.end(), name);
+                    }
+
+                    _push_operand(_LOAD, iter - names.begin());
+                }
+                else
+                {
+                    throw std::runtime_error(utils::format("Invalid expression - unexpected symbol %c", c));
+                }
+            }
+
+            void _unary()
+            {
+                _enter();
+                if (_accept("+"))
+                {
+                    _unary();
+                }
+                else if (_accept("-"))
+                {
+                    _unary();
+                    _emit(_NEGATE);
+                }
+                else if (_accept("!"))
+                {
+                    _unary();
+                    _emit(_NOT);
+                }
+                else if (_accept("~"))
+                {
+                    _require_integers("~");
+                    _unary();
+                    _emit(_BITWISE_NOT);
+                }
+                else
+                {
+                    _primary();
+                }
+
+                _nesting--;
+            }
+
+            /** @brief Identify the binary operator at the current position, its length is 0 if there is none */
+            _BinaryOperator _peek_binary_operator() const
+            {
+                const char c = _position < _expression.size() ? _expression[_position] : '\0';
+                const char next = _position + 1 < _expression.size() ? _expression[_position + 1] : '\0';
+                switch (c)
+                {
+                case '|':
+                    return next == '|' ? _BinaryOperator{_OR_JUMP_IF_NONZERO, 1, 2} : _BinaryOperator{_BITWISE_OR, 3, 1};
+                case '&':
+                    return next == '&' ? _BinaryOperator{_AND_JUMP_IF_ZERO, 2, 2} : _BinaryOperator{_BITWISE_AND, 5, 1};
+                case '^':
+                    return {_BITWISE_XOR, 4, 1};
+                case '=':
+                    // A single "=" is not an operator
+                    return next == '=' ? _BinaryOperator{_EQUAL, 6, 2} : _BinaryOperator{_PUSH, 0, 0};
+                case '!':
+                    return next == '=' ? _BinaryOperator{_NOT_EQUAL, 6, 2} : _BinaryOperator{_PUSH, 0, 0};
+                case '<':
+                    if (next == '<')
+                        return {_SHIFT_LEFT, 8, 2};
+                    return next == '=' ? _BinaryOperator{_LESS_EQUAL, 7, 2} : _BinaryOperator{_LESS, 7, 1};
+                case '>':
+                    if (next == '>')
+                        return {_SHIFT_RIGHT, 8, 2};
+                    return next == '=' ? _BinaryOperator{_GREATER_EQUAL, 7, 2} : _BinaryOperator{_GREATER, 7, 1};
+                case '+':
+                    return {_ADD, 9, 1};
+                case '-':
+                    return {_SUBTRACT, 9, 1};
+                case '*':
+                    return {_MULTIPLY, 10, 1};
+                case '/':
+                    return {_DIVIDE, 10, 1};
+                case '%':
+                    return {_MODULO, 10, 1};
+                default:
+                    return {_PUSH, 0, 0};
+                }
+            }
+
+            /** @brief Parse a chain of binary operators with at least the given precedence (precedence climbing) */
+            void _binary(const int min_precedence)
+            {
+                _unary();
+                while (true)
+                {
+                    _skip_spaces();
+
+                    const auto found = _peek_binary_operator();
+                    if (found.length == 0 || found.precedence < min_precedence)
+                    {
+                        return;
+                    }
+
+                    switch (found.opcode)
+                    {
+                    case _SHIFT_LEFT:
+                    case _SHIFT_RIGHT:
+                    case _BITWISE_AND:
+                    case _BITWISE_XOR:
+                    case _BITWISE_OR:
+                        _require_integers(_expression.substr(_position, found.length));
+                        break;
+                    default:
+                        break;
+                    }
+
+                    _position += found.length;
+                    if (found.opcode == _AND_JUMP_IF_ZERO || found.opcode == _OR_JUMP_IF_NONZERO)
+                    {
+                        // The jump pops the left operand when it falls through to the right one
+                        auto jump = _emit(found.opcode);
+                        _depth--;
+                        _binary(found.precedence + 1);
+                        _emit(_TO_BOOLEAN);
+                        _patch(jump);
+                    }
+                    else
+                    {
+                        _binary(found.precedence + 1);
+                        _emit(found.opcode);
+                        _depth--;
+                    }
+                }
+            }
+
+            void _ternary()
+            {
+                _enter();
+                _binary(1);
+                if (_accept("?"))
+                {
+                    auto jump_to_false = _emit(_JUMP_IF_ZERO);
+                    _depth--;
+
+                    _ternary();
+                    if (!_accept(":"))
+                    {
+                        throw std::runtime_error("Invalid expression - missing \":\" of a conditional operator");
+                    }
+
+                    auto jump_to_end = _emit(_JUMP);
+                    _depth--; // exactly one of the branches is evaluated
+                    _patch(jump_to_false);
+
+                    _ternary();
+                    _patch(jump_to_end);
+                }
+
+                _nesting--;
+            }
+
+        public:
+            _Compiler(const std::string_view &expression, Expression &result)
+                : _expression(expression), _result(result) {}
+
+            void compile()
+            {
+                _skip_spaces();
+                if (_position == _expression.size())
+                {
+                    return; // an empty expression evaluates to 0
+                }
+
+                _ternary();
+                _skip_spaces();
+                if (_position < _expression.size())
+                {
+                    if (_expression[_position] == ')')
+                    {
+                        throw std::runtime_error("Invalid expression - missing bracket");
+                    }
+
+                    throw std::runtime_error(utils::format("Invalid expression - unexpected symbol %c", _expression[_position]));
+                }
+            }
+        };
+
+    public:
+        /**
+         * @brief Compile a mathematical expression
+         *
+         * @param expression The expression to compile
+         * @param floating Whether to compile in floating-point mode
+         * @return The compiled expression
+         */
+        static Expression compile(const std::string_view &expression, const bool floating = false)
+        {
+            for (auto &c : expression)
+            {
+                if (!utils::is_math_symbol(c) && !utils::is_word_character(c))
+                {
+                    throw std::runtime_error(utils::format("Unrecognized symbol: %c", c));
+                }
+            }
+
+            Expression result;
+            result._floating = floating;
+            _Compiler(expression, result).compile();
+
+            result._program.shrink_to_fit();
+            return result;
+        }
+
+        /** @brief Whether this expression was compiled in floating-point mode */
+        bool floating() const
+        {
+            return _floating;
+        }
+
+        /**
+         * @brief Evaluate this expression
+         *
+         * @tparam T `long long` for expressions compiled in integer mode, `double` in floating-point mode
+         * @param lookup A callable accepting the name of an identifier (as `std::string_view`) and returning its
+         * value as `T`
+         * @return The result of the evaluation, or 0 if the expression is empty
+         */
+        template <typename T = long long, typename F>
+        T evaluate(const F &lookup) const
+        {
+            constexpr bool floating_point = std::is_floating_point_v<T>;
+            if (floating_point != _floating)
+            {
+                throw std::logic_error("The expression was compiled in another mode");
+            }
+
+            T stack[LITE_SHELL_EXPRESSION_STACK_LIMIT];
+            std::size_t size = 0;
+            for (std::size_t pc = 0; pc < _program.size(); pc++)
+            {
+                const auto &instruction = _program[pc];
+                switch (instruction.opcode)
+                {
+                case _PUSH:
+                    if constexpr (floating_point)
+                    {
+                        stack[size++] = instruction.constant;
+                    }
+                    else
+                    {
+                        stack[size++] = instruction.operand;
+                    }
+                    break;
+                case _LOAD:
+                    stack[size++] = lookup(std::string_view(_names[instruction.operand]));
+                    break;
+                case _NEGATE:
+                    if constexpr (floating_point)
+                    {
+                        stack[size - 1] = -stack[size - 1];
+                    }
+                    else if (__builtin_sub_overflow(T(0), stack[size - 1], &stack[size - 1]))
+                    {
+                        throw std::runtime_error("Invalid expression - integer overflow in negation");
+                    }
+                    break;
+                case _NOT:
+                    stack[size - 1] = !stack[size - 1];
+                    break;
+                case _BITWISE_NOT:
+                    if constexpr (!floating_point)
+                    {
+                        stack[size - 1] = ~stack[size - 1];
+                    }
+                    break;
+                case _TO_BOOLEAN:
+                    stack[size - 1] = stack[size - 1] != 0;
+                    break;
+                case _JUMP:
+                    pc = instruction.operand - 1; // the loop increments pc
+                    break;
+                case _JUMP_IF_ZERO:
+                    if (stack[--size] == 0)
+                    {
+                        pc = instruction.operand - 1;
+                    }
+                    break;
+                case _AND_JUMP_IF_ZERO:
+                    if (stack[size - 1] == 0)
+                    {
+                        pc = instruction.operand - 1;
+                    }
+                    else
+                    {
+                        size--;
+                    }
+                    break;
+                case _OR_JUMP_IF_NONZERO:
+                    if (stack[size - 1] != 0)
+                    {
+                        stack[size - 1] = 1;
+                        pc = instruction.operand - 1;
+                    }
+                    else
+                    {
+                        size--;
+                    }
+                    break;
+                default:
+                {
+                    // Binary operators
+                    const T r = stack[--size];
+                    T &l = stack[size - 1];
+                    switch (instruction.opcode)
+                    {
+                    // Signed integer overflow is undefined behavior, hence the checked arithmetic
+                    case _ADD:
+                        if constexpr (floating_point)
+                        {
+                            l += r;
+                        }
+                        else if (__builtin_add_overflow(l, r, &l))
+                        {
+                            throw std::runtime_error("Invalid expression - integer overflow in addition");
+                        }
+                        break;
+                    case _SUBTRACT:
+                        if constexpr (floating_point)
+                        {
+                            l -= r;
+                        }
+                        else if (__builtin_sub_overflow(l, r, &l))
+                        {
+                            throw std::runtime_error("Invalid expression - integer overflow in subtraction");
+                        }
+                        break;
+                    case _MULTIPLY:
+                        if constexpr (floating_point)
+                        {
+                            l *= r;
+                        }
+                        else if (__builtin_mul_overflow(l, r, &l))
+                        {
+                            throw std::runtime_error("Invalid expression - integer overflow in multiplication");
+                        }
+                        break;
+                    case _DIVIDE:
+                    case _MODULO:
+                        if (r == 0)
+                        {
+                            throw std::runtime_error("Invalid expression - division by zero");
+                        }
+
+                        if constexpr (floating_point)
+                        {
+                            l = instruction.opcode == _DIVIDE ? l / r : std::fmod(l, r);
+                        }
+                        else if (r == -1)
+                        {
+                            // The minimum value divided by -1 does not fit (and traps on x86, even for %)
+                            if (instruction.opcode == _MODULO)
+                            {
+                                l = 0;
+                            }
+                            else if (l == std::numeric_limits<T>::min())
+                            {
+                                throw std::runtime_error("Invalid expression - integer overflow in division");
+                            }
+                            else
+                            {
+                                l = -l;
+                            }
+                        }
+                        else
+                        {
+                            l = instruction.opcode == _DIVIDE ? l / r : l % r;
+                        }
+                        break;
+                    case _LESS:
+                        l = l < r;
+                        break;
+                    case _GREATER:
+                        l = l > r;
+                        break;
+                    case _LESS_EQUAL:
+                        l = l <= r;
+                        break;
+                    case _GREATER_EQUAL:
+                        l = l >= r;
+                        break;
+                    case _EQUAL:
+                        l = l == r;
+                        break;
+                    case _NOT_EQUAL:
+                        l = l != r;
+                        break;
+                    default:
+                        if constexpr (floating_point)
+                        {
+                            throw std::runtime_error(utils::format("Invalid expression - unknown opcode %d", instruction.opcode));
+                        }
+                        else
+                        {
+                            switch (instruction.opcode)
+                            {
+                            case _SHIFT_LEFT:
+                            case _SHIFT_RIGHT:
+                                if (r < 0 || r >= 64)
+                                {
+                                    throw std::runtime_error(utils::format("Invalid expression - shift count %lld is out of range", r));
+                                }
+
+                                l = instruction.opcode == _SHIFT_LEFT ? (long long)((unsigned long long)l << r) : l >> r;
+                                break;
+                            case _BITWISE_AND:
+                                l &= r;
+                                break;
+                            case _BITWISE_XOR:
+                                l ^= r;
+                                break;
+                            case _BITWISE_OR:
+                                l |= r;
+                                break;
+                            default:
+                                throw std::runtime_error(utils::format("Invalid expression - unknown opcode %d", instruction.opcode));
+                            }
+                        }
+                    }
+                }
+                }
+            }
+
+            return size == 0 ? 0 : stack[size - 1];
+        }
+    };
+
+    /**
+     * @brief A least-recently-used cache of compiled expressions, keyed by their text.
+     *
+     * Scripts typically evaluate the same few expressions in a loop, so most lookups skip compilation entirely.
+     */
+    class ExpressionCache
+    {
+    private:
+        /** @brief Entries ordered from the most to the least recently used */
+        std::list<std::pair<std::string, Expression>> _entries;
+
+        /** @brief Index of `_entries`, the keys are views of the strings stored in the list nodes */
+        std::unordered_map<std::string_view, std::list<std::pair<std::string, Expression>>::iterator> _index;
+
+        const std::size_t _capacity;
+        const bool _floating;
+
+    public:
+        /**
+         * @brief Construct a new `ExpressionCache` object
+         *
+         * @param floating Whether to compile expressions in floating-point mode
+         * @param capacity The maximum number of expressions to keep
+         */
+        ExpressionCache(const bool floating = false, const std::size_t capacity = LITE_SHELL_EXPRESSION_CACHE_SIZE)
+            : _capacity(capacity), _floating(floating) {}
+
+        /**
+         * @brief Get the compiled form of an expression, compiling it if it is not cached
+         *
+         * @param expression The expression to look up
+         * @return A reference to the compiled expression, valid until the next call to `get`
+         */
+        const Expression &get(const std::string_view &expression)
+        {
+            auto iter = _index.find(expression);
+            if (iter != _index.end())
+            {
+                if (iter->second != _entries.begin())
+                {
+                    _entries.splice(_entries.begin(), _entries, iter->second);
+                }
+
+                return iter->second->second;
+            }
+
+            // Compile first: an invalid expression must not evict anything
+            auto compiled = Expression::compile(expression, _floating);
+            if (_entries.size() >= _capacity)
+            {
+                _index.erase(_entries.back().first);
+                _entries.pop_back();
+            }
+
+            _entries.emplace_front(std::string(expression), std::move(compiled));
+            _index.emplace(_entries.front().first, _entries.begin());
+            return _entries.front().second;
+        }
+
+        /** @brief The number of cached expressions */
+        std::size_t size() const
+        {
+            return _entries.size();
+        }
+    };
+}
@@ -0,0 +1,359 @@
+#pragma once
+
+#include "standard.hpp"
+
+namespace utils
+{
+    /**
+     * @brief An open-addressing hash table keyed by `std::string_view`
+     *
+     * All slots live in a single contiguous array and collisions are resolved with linear probing, so a lookup
+     * usually touches a single cache line. Lookups accept any `std::string_view` and never allocate.
+     *
+     * The table does not own its keys: the caller must keep the memory referred to by each inserted key alive
+     * for as long as the table (see `InternPool`).
+     *
+     * @tparam V The value type
+     */
+    template <typename V>
+    class FlatStringMap
+    {
+    private:
+        struct _Slot
+        {
+            std::size_t hash = 0;
+            std::string_view key;
+            V value = V();
+            bool used = false;
+        };
+
+        std::vector<_Slot> _slots;
+        std::size_t _size = 0;
+
+        static std::size_t _hash(const std::string_view &key)
+        {
+            return std::hash<std::string_view>()(key);
+        }
+
+        /** @brief Find the slot holding `key`, or the empty slot where it would be inserted */
+        std::size_t _probe(const std::string_view &key, const std::size_t hash) const
+        {
+            const std::size_t mask = _slots.size() - 1;
+            std::size_t index = hash & mask;
+            while (_slots[index].used && (_slots[index].hash != hash || _slots[index].key != key))
+            {
+                index = (index + 1) & mask;
+            }
+
+            return index;
+        }
+
+        void _rehash(const std::size_t capacity)
+        {
+            std::vector<_Slot> old(capacity);
+            old.swap(_slots);
+            for (auto &slot : old)
+            {
+                if (slot.used)
+                {
+                    _slots[_probe(slot.key, slot.hash)] = std::move(slot);
+                }
+            }
+        }
+
+    public:
+        /** @brief Construct an empty table */
+        FlatStringMap() {}
+
+        /** @brief The number of keys in this table */
+        std::size_t size() const
+        {
+            return _size;
+        }
+
+        /** @brief Whether this table is empty */
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
+        /**
+         * @brief Ensure the table can hold `count` keys without rehashing
+         *
+         * @param count The expected number of keys
+         */
+        void reserve(const std::size_t count)
+        {
+            std::size_t capacity = std::max<std::size_t>(_slots.size(), 8);
+            while (count * 4 >= capacity * 3)
+            {
+                capacity *= 2;
+            }
+
+            if (capacity != _slots.size())
+            {
+                _rehash(capacity);
+            }
+        }
+
+        /**
+         * @brief Get a pointer to the value of a key
+         *
+         * @param key The key to look up
+         * @return A pointer to the value, or `NULL` if the key does not exist
+         */
+        V *find(const std::string_view &key)
+        {
+            if (_size == 0)
+            {
+                return NULL;
+            }
+
+            auto &slot = _slots[_probe(key, _hash(key))];
+            return slot.used ? &slot.value : NULL;
+        }
+
+        /** @copydoc FlatStringMap::find */
+        const V *find(const std::string_view &key) const
+        {
+            return const_cast<FlatStringMap *>(this)->find(key);
+        }
+
+        /**
+         * @brief Get the value of a key, inserting a default value if the key does not exist
+         *
+         * @param key The key to look up. If a new entry is created, the memory this view refers to must outlive
+         * the table.
+         * @param inserted Set to whether a new entry was created (optional)
+         * @return A reference to the value, which remains valid until the next insertion
+         */
+        V &emplace(const std::string_view &key, bool *inserted = NULL)
+        {
+            reserve(_size + 1);
+
+            const auto hash = _hash(key);
+            auto &slot = _slots[_probe(key, hash)];
+            if (inserted != NULL)
+            {
+                *inserted = !slot.used;
+            }
+
+            if (!slot.used)
+            {
+                slot.hash = hash;
+                slot.key = key;
+                slot.used = true;
+                _size++;
+            }
+
+            return slot.value;
+        }
+
+        /**
+         * @brief Remove a key from the table
+         *
+         * The following entries of the probe sequence are shifted back, so lookups never stop at a hole and no
+         * tombstone is left behind. Pointers to other values of the table may be invalidated.
+         *
+         * @param key The key to remove
+         * @return Whether the key existed
+         */
+        bool erase(const std::string_view &key)
+        {
+            if (_size == 0)
+            {
+                return false;
+            }
+
+            const std::size_t mask = _slots.size() - 1;
+            auto hole = _probe(key, _hash(key));
+            if (!_slots[hole].used)
+            {
+                return false;
+            }
+
+            for (auto index = (hole + 1) & mask; _slots[index].used; index = (index + 1) & mask)
+            {
+                // An entry may fill the hole unless its home slot lies cyclically in (hole, index]
+                const auto home = _slots[index].hash & mask;
+                if (((index - home) & mask) >= ((index - hole) & mask))
+                {
+                    _slots[hole] = std::move(_slots[index]);
+                    hole = index;
+                }
+            }
+
+            _slots[hole] = _Slot();
+            _size--;
+            return true;
+        }
+
+        /**
+         * @brief Invoke a function for each entry of the table, in no particular order
+         *
+         * @param function A callable accepting `(std::string_view key, const V &value)`
+         */
+        template <typename F>
+        void for_each(const F &function) const
+        {
+            for (auto &slot : _slots)
+            {
+                if (slot.used)
+                {
+                    function(slot.key, slot.value);
+                }
+            }
+        }
+
+        /** @brief Remove all entries of the table */
+        void clear()
+        {
+            _slots.clear();
+            _size = 0;
+        }
+    };
+
+    /**
+     * @brief A reference-counted pool of unique strings
+     *
+     * Interning a string returns a view into storage owned by the pool. Interning equal strings twice returns the
+     * same view, so interned names can be used as keys of `FlatStringMap` without copying them per table. Each
+     * `intern` adds a reference, and a string is freed once `release` has dropped all of them, so the pool only
+     * holds the strings still in use.
+     */
+    class InternPool
+    {
+    private:
+        struct _Entry
+        {
+            /** @brief The interned string, which never moves while the entry exists */
+            std::unique_ptr<char[]> data;
+
+            /** @brief Used instead of `data` by strings interned with `intern_all`, pointing into a shared block */
+            std::shared_ptr<const char> block;
+
+            std::size_t references = 0;
+
+            const char *get() const
+            {
+                return data == nullptr ? block.get() : data.get();
+            }
+        };
+
+        FlatStringMap<_Entry> _index;
+
+        InternPool(const InternPool &) = delete;
+        InternPool &operator=(const InternPool &) = delete;
+
+    public:
+        /** @brief Construct an empty pool */
+        InternPool() {}
+
+        /**
+         * @brief Get the interned copy of a string, creating it if necessary, and add a reference to it
+         *
+         * @param value The string to intern
+         * @return A view of the interned string, valid until the matching `release` (or for the lifetime of the
+         * pool if the reference is never released)
+         */
+        std::string_view intern(const std::string_view &value)
+        {
+            auto found = _index.find(value);
+            if (found != NULL)
+            {
+                found->references++;
+                return std::string_view(found->get(), value.size());
+            }
+
+            auto data = std::make_unique<char[]>(value.size());
+            std::copy(value.begin(), value.end(), data.get());
+
+            const std::string_view result(data.get(), value.size());
+            auto &entry = _index.emplace(result);
+            entry.data = std::move(data);
+            entry.references = 1;
+            return result;
+        }
+
+        /**
+         * @brief Intern a batch of strings, adding a reference to each
+         *
+         * The strings not interned yet are copied into a single block, which is freed once all of them are
+         * released, instead of being allocated one by one.
+         *
+         * @param values The strings to intern
+         * @return The views of the interned strings, in the same order, see `intern`
+         */
+        std::vector<std::string_view> intern_all(const std::vector<std::string_view> &values)
+        {
+            _index.reserve(_index.size() + values.size());
+
+            std::size_t size = 0;
+            for (auto &value : values)
+            {
+                if (_index.find(value) == NULL)
+                {
+                    size += value.size();
+                }
+            }
+
+            std::shared_ptr<char> block(new char[size], std::default_delete<char[]>());
+            char *next = block.get();
+
+            std::vector<std::string_view> result;
+            result.reserve(values.size());
+            for (auto &value : values)
+            {
+                // Also finds a duplicate within the batch
+                auto found = _index.find(value);
+                if (found != NULL)
+                {
+                    found->references++;
+                    result.emplace_back(found->get(), value.size());
+                    continue;
+                }
+
+                std::copy(value.begin(), value.end(), next);
+
+                const std::string_view interned(next, value.size());
+                auto &entry = _index.emplace(interned);
+                entry.block = std::shared_ptr<const char>(block, next);
+                entry.references = 1;
+                result.push_back(interned);
+                next += value.size();
+            }
+
+            return result;
+        }
+
+        /**
+         * @brief Drop a reference added by `intern`, freeing the string once no reference is left
+         *
+         * @param interned A view returned by `intern`
+         */
+        void release(const std::string_view &interned)
+        {
+            auto entry = _index.find(interned);
+            if (entry != NULL && --entry->references == 0)
+            {
+                _index.erase(interned);
+            }
+        }
+
+        /**
+         * @brief Ensure the pool can hold `count` strings without rehashing its index
+         *
+         * @param count The expected number of strings
+         */
+        void reserve(const std::size_t count)
+        {
+            _index.reserve(count);
+        }
+
+        /** @brief The number of unique strings in this pool */
+        std::size_t size() const
+        {
+            return _index.size();
+        }
+    };
+}
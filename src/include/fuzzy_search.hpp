@@ -5,71 +5,143 @@
 namespace utils
 {
     /**
-     * @brief Search for the closest matching string in a given range
-     *
-     * Search for a string in range [`first`, `last`) that is closest to `value`
+     * @brief Compute Levenshtein distances from a fixed pattern with Myers' bit-parallel algorithm
      *
-     * @param first An iterator pointing to the first string
-     * @param last An iterator pointing after last string
-     * @param value The value to search for
+     * Each column of the dynamic programming table is encoded as bit vectors of vertical deltas, so a text
+     * character costs a handful of word operations for patterns of up to 64 characters. Longer patterns fall back
+     * to the classic two-row algorithm.
      *
-     * @return An iterator pointing to the string that is closest to `value`
+     * @see https://doi.org/10.1145/316542.316550
      */
-    template <typename _ForwardIterator>
-    _ForwardIterator fuzzy_search(const _ForwardIterator &first, const _ForwardIterator &last, const std::string &value)
+    class LevenshteinPattern
     {
-        if (first == last)
+    private:
+        const std::string _pattern;
+        std::array<std::uint64_t, 256> _peq{};
+
+        std::size_t _fallback_distance(const std::string_view &text, const std::size_t cutoff) const
         {
-            throw std::invalid_argument("fuzzy_search got an empty range");
-        }
+            std::vector<std::size_t> previous(text.size() + 1), current(text.size() + 1);
+            std::iota(previous.begin(), previous.end(), 0);
+            for (std::size_t i = 0; i < _pattern.size(); i++)
+            {
+                current[0] = i + 1;
+                auto row_minimum = current[0];
+                for (std::size_t j = 0; j < text.size(); j++)
+                {
+                    current[j + 1] = std::min(previous[j] + (_pattern[i] != text[j]), previous[j + 1] + 1, current[j] + 1);
+                    row_minimum = std::min(row_minimum, current[j + 1]);
+                }
+
+                // The minimum of a row never decreases in the following rows
+                if (row_minimum >= cutoff)
+                {
+                    return cutoff;
+                }
 
-        int n, m;
-        std::string compare;
-        std::vector<std::vector<int>> dp;
+                previous.swap(current);
+            }
+
+            return std::min(previous.back(), cutoff);
+        }
 
-        std::function<int(int, int)> distance;
-        distance = [&value, &n, &m, &compare, &dp, &distance](int value_index, int compare_index)
+    public:
+        /** @param pattern The string to compute distances from */
+        explicit LevenshteinPattern(const std::string_view &pattern) : _pattern(pattern)
         {
-            if (dp[value_index][compare_index] > -1)
+            for (std::size_t i = 0; i < std::min<std::size_t>(_pattern.size(), 64); i++)
             {
-                return dp[value_index][compare_index];
+                _peq[static_cast<unsigned char>(_pattern[i])] |= std::uint64_t(1) << i;
             }
+        }
 
-            int result = -1;
-            if (value_index == n)
+        /**
+         * @brief Compute the edit distance between the pattern and a text
+         *
+         * @param text The text to compare with
+         * @param cutoff Stop as soon as the distance is known to be at least this value
+         * @return The edit distance, or `cutoff` if it is at least `cutoff`
+         */
+        std::size_t distance(const std::string_view &text, const std::size_t cutoff = SIZE_MAX) const
+        {
+            const auto n = _pattern.size(), m = text.size();
+            if ((n > m ? n - m : m - n) >= cutoff)
             {
-                result = m - compare_index;
+                return cutoff;
             }
-            else if (compare_index == m)
+
+            if (n == 0)
             {
-                result = n - value_index;
+                return m;
             }
-            else if (value[value_index] == compare[compare_index])
+
+            if (n > 64)
             {
-                result = distance(value_index + 1, compare_index + 1);
+                return _fallback_distance(text, cutoff);
             }
-            else
+
+            const std::uint64_t last = std::uint64_t(1) << (n - 1);
+            std::uint64_t pv = ~std::uint64_t(0), mv = 0;
+            std::size_t score = n;
+            for (std::size_t j = 0; j < m; j++)
             {
-                result = 1 + std::min(
-                                 distance(value_index, compare_index + 1),
-                                 distance(value_index + 1, compare_index),
-                                 distance(value_index + 1, compare_index + 1));
+                const auto eq = _peq[static_cast<unsigned char>(text[j])];
+                const auto xv = eq | mv;
+                const auto xh = (((eq & pv) + pv) ^ pv) | eq;
+                auto ph = mv | ~(xh | pv);
+                auto mh = pv & xh;
+                if (ph & last)
+                {
+                    score++;
+                }
+                else if (mh & last)
+                {
+                    score--;
+                }
+
+                // The final distance is at least the current one minus the remaining characters
+                const auto remaining = m - j - 1;
+                if (score > remaining && score - remaining >= cutoff)
+                {
+                    return cutoff;
+                }
+
+                ph = (ph << 1) | 1;
+                mh <<= 1;
+                pv = mh | ~(xv | ph);
+                mv = ph & xv;
             }
 
-            return dp[value_index][compare_index] = result;
-        };
+            return score;
+        }
+    };
 
-        int min_diff = INT_MAX;
-        _ForwardIterator result;
-        for (auto iter = first; iter != last; iter++)
+    /**
+     * @brief Search for the closest matching string in a given range
+     *
+     * Search for a string in range [`first`, `last`) that is closest to `value` in Levenshtein distance
+     *
+     * @param first An iterator pointing to the first string
+     * @param last An iterator pointing after last string
+     * @param value The value to search for
+     *
+     * @return An iterator pointing to the first string that is closest to `value`
+     */
+    template <typename _ForwardIterator>
+    _ForwardIterator fuzzy_search(const _ForwardIterator &first, const _ForwardIterator &last, const std::string_view &value)
+    {
+        if (first == last)
         {
-            compare = *iter;
-            n = value.size();
-            m = compare.size();
-            dp.clear();
-            dp.resize(n + 1, std::vector<int>(m + 1, -1));
+            throw std::invalid_argument("fuzzy_search got an empty range");
+        }
 
-            int diff = distance(0, 0);
+        const LevenshteinPattern pattern(value);
+        std::size_t min_diff = SIZE_MAX;
+        _ForwardIterator result = first;
+        for (auto iter = first; iter != last && min_diff > 0; iter++)
+        {
+            // Only a strictly closer string can replace the current result
+            auto diff = pattern.distance(*iter, min_diff);
             if (diff < min_diff)
             {
                 min_diff = diff;
@@ -13,7 +13,28 @@ namespace utils
     class CaseInsensitiveMap
     {
     private:
-        typedef typename std::map<std::string, V> _map_type;
+        /** @brief A transparent comparator, so that lookups need neither a lowercase copy nor an `std::string` */
+        struct _case_insensitive_less
+        {
+            typedef void is_transparent;
+
+            bool operator()(const std::string_view &first, const std::string_view &second) const
+            {
+                auto size = std::min(first.size(), second.size());
+                for (std::size_t i = 0; i < size; i++)
+                {
+                    auto a = std::tolower(static_cast<unsigned char>(first[i])), b = std::tolower(static_cast<unsigned char>(second[i]));
+                    if (a != b)
+                    {
+                        return a < b;
+                    }
+                }
+
+                return first.size() < second.size();
+            }
+        };
+
+        typedef typename std::map<std::string, V, _case_insensitive_less> _map_type;
 
         _map_type _map;
 
@@ -65,16 +86,22 @@ namespace utils
             return _map.cend();
         }
 
+        /** @brief Return the number of elements */
+        std::size_t size() const
+        {
+            return _map.size();
+        }
+
         /** @brief Get iterator to element */
-        iterator find(const std::string &key)
+        iterator find(const std::string_view &key)
         {
-            return _map.find(to_lowercase(key));
+            return _map.find(key);
         }
 
         /** @brief Get const_iterator to element */
-        const_iterator find(const std::string &key) const
+        const_iterator find(const std::string_view &key) const
         {
-            return _map.find(to_lowercase(key));
+            return _map.find(key);
         }
     };
 }
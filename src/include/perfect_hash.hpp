@@ -0,0 +1,287 @@
+#pragma once
+
+#include "standard.hpp"
+
+namespace utils
+{
+    /**
+     * @brief An immutable hash table keyed by strings, built with a collision-free (perfect) hash function
+     *
+     * The table is built once from a fixed set of keys with the hash-and-displace scheme: keys are first split into
+     * small buckets, then each bucket gets a seed (its displacement) such that its keys land in free slots. The
+     * table has exactly one slot per key. A lookup hashes the key once, reads the displacement of its bucket and
+     * compares the key against a single slot, without probing and without allocating.
+     *
+     * The table owns copies of its keys (packed in a single string), so it can be freely copied.
+     *
+     * @see https://doi.org/10.1007/978-3-642-04128-0_61
+     * @tparam V The value type
+     * @tparam CaseInsensitive Whether keys are compared ignoring ASCII case (both when hashing and comparing, so
+     * that lookups never build a lowercase copy)
+     */
+    template <typename V, bool CaseInsensitive = false>
+    class PerfectHashMap
+    {
+    private:
+        struct _Slot
+        {
+            std::uint64_t hash = 0;
+            std::size_t offset = 0, length = 0;
+            V value = V();
+        };
+
+        /** @brief The average number of keys per bucket */
+        static const std::size_t _bucket_size = 2;
+
+        std::string _keys;
+        std::vector<_Slot> _slots;
+
+        /**
+         * @brief The displacement of each bucket: a seed if non-negative, otherwise `-1 - slot` for a bucket with
+         * a single key placed directly
+         */
+        std::vector<std::int32_t> _displacements;
+
+        static unsigned char _fold(const char c)
+        {
+            if constexpr (CaseInsensitive)
+            {
+                return static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+            else
+            {
+                return static_cast<unsigned char>(c);
+            }
+        }
+
+        /** @brief FNV-1a, which is faster than `std::hash` on the short keys these tables are built for */
+        static std::uint64_t _hash(const std::string_view &key)
+        {
+            std::uint64_t hash = 14695981039346656037ull;
+            for (auto c : key)
+            {
+                hash = (hash ^ _fold(c)) * 1099511628211ull;
+            }
+
+            return hash;
+        }
+
+        static bool _equal(const std::string_view &first, const std::string_view &second)
+        {
+            if constexpr (!CaseInsensitive)
+            {
+                return first == second;
+            }
+
+            if (first.size() != second.size())
+            {
+                return false;
+            }
+
+            for (std::size_t i = 0; i < first.size(); i++)
+            {
+                if (_fold(first[i]) != _fold(second[i]))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /** @brief Map a hash to `[0, n)` with a multiplication instead of a (much slower) division */
+        static std::size_t _reduce(const std::uint64_t hash, const std::size_t n)
+        {
+            return static_cast<std::size_t>(((hash >> 32) * n) >> 32);
+        }
+
+        /** @brief Derive the slot of a key from its hash and the seed of its bucket (the splitmix64 finalizer) */
+        std::size_t _slot(const std::uint64_t hash, const std::int32_t seed) const
+        {
+            auto z = hash + (static_cast<std::uint64_t>(seed) + 1) * 0x9e3779b97f4a7c15ull;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return _reduce(z ^ (z >> 31), _slots.size());
+        }
+
+        std::size_t _bucket(const std::uint64_t hash) const
+        {
+            // Use the low bits, independent from the high bits that `_slot` reduces
+            return _reduce(hash << 32, _displacements.size());
+        }
+
+    public:
+        /** @brief Construct an empty table */
+        PerfectHashMap() {}
+
+        /**
+         * @brief Construct a table holding the given entries
+         *
+         * @param entries The key-value pairs, whose keys must be distinct
+         * @throw `std::invalid_argument` if a key appears twice
+         */
+        PerfectHashMap(const std::vector<std::pair<std::string, V>> &entries)
+        {
+            std::unordered_set<std::string> keys;
+            std::vector<std::uint64_t> hashes;
+            hashes.reserve(entries.size());
+            for (auto &[key, _] : entries)
+            {
+                std::string folded(key);
+                for (auto &c : folded)
+                {
+                    c = _fold(c);
+                }
+
+                if (!keys.insert(folded).second)
+                {
+                    throw std::invalid_argument("Duplicate key \"" + key + "\" in perfect hash table");
+                }
+
+                hashes.push_back(_hash(key));
+            }
+
+            if (entries.empty())
+            {
+                return;
+            }
+
+            // No seed can separate 2 distinct keys with the same 64-bit hash
+            if (std::unordered_set<std::uint64_t>(hashes.begin(), hashes.end()).size() != hashes.size())
+            {
+                throw std::runtime_error("Unable to build a perfect hash table");
+            }
+
+            _slots.resize(entries.size());
+            _displacements.resize((entries.size() + _bucket_size - 1) / _bucket_size);
+
+            std::vector<std::vector<std::size_t>> buckets(_displacements.size());
+            for (std::size_t i = 0; i < entries.size(); i++)
+            {
+                buckets[_bucket(hashes[i])].push_back(i);
+            }
+
+            // Place the largest buckets first, while most slots are still free
+            std::vector<std::size_t> order(buckets.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(
+                order.begin(), order.end(),
+                [&buckets](std::size_t first, std::size_t second)
+                {
+                    return buckets[first].size() > buckets[second].size();
+                });
+
+            std::vector<bool> occupied(_slots.size());
+            std::vector<std::size_t> placed;
+            std::size_t free_slot = 0;
+            for (auto b : order)
+            {
+                const auto &bucket = buckets[b];
+                if (bucket.empty())
+                {
+                    break;
+                }
+
+                if (bucket.size() == 1)
+                {
+                    // Any free slot will do: store it directly
+                    while (occupied[free_slot])
+                    {
+                        free_slot++;
+                    }
+
+                    occupied[free_slot] = true;
+                    _displacements[b] = -1 - static_cast<std::int32_t>(free_slot);
+                    _slots[free_slot].value = entries[bucket[0]].second;
+                    _slots[free_slot].hash = hashes[bucket[0]];
+                    continue;
+                }
+
+                for (std::int32_t seed = 0;; seed++)
+                {
+                    if (seed == INT32_MAX)
+                    {
+                        throw std::runtime_error("Unable to build a perfect hash table");
+                    }
+
+                    placed.clear();
+                    for (auto i : bucket)
+                    {
+                        auto slot = _slot(hashes[i], seed);
+                        if (occupied[slot])
+                        {
+                            break;
+                        }
+
+                        occupied[slot] = true;
+                        placed.push_back(slot);
+                    }
+
+                    if (placed.size() == bucket.size())
+                    {
+                        _displacements[b] = seed;
+                        for (std::size_t j = 0; j < bucket.size(); j++)
+                        {
+                            _slots[placed[j]].value = entries[bucket[j]].second;
+                            _slots[placed[j]].hash = hashes[bucket[j]];
+                        }
+
+                        break;
+                    }
+
+                    for (auto slot : placed)
+                    {
+                        occupied[slot] = false;
+                    }
+                }
+            }
+
+            // Pack the keys in slot order
+            std::vector<std::size_t> key_of_slot(_slots.size());
+            for (std::size_t i = 0; i < entries.size(); i++)
+            {
+                auto index = _bucket(hashes[i]);
+                key_of_slot[_displacements[index] < 0 ? -1 - _displacements[index] : _slot(hashes[i], _displacements[index])] = i;
+            }
+
+            for (std::size_t slot = 0; slot < _slots.size(); slot++)
+            {
+                const auto &key = entries[key_of_slot[slot]].first;
+                _slots[slot].offset = _keys.size();
+                _slots[slot].length = key.size();
+                _keys += key;
+            }
+        }
+
+        /**
+         * @brief Get a pointer to the value of a key
+         *
+         * @param key The key to look up
+         * @return A pointer to the value, or `NULL` if the key does not exist
+         */
+        const V *find(const std::string_view &key) const
+        {
+            if (_slots.empty())
+            {
+                return NULL;
+            }
+
+            const auto hash = _hash(key);
+            const auto displacement = _displacements[_bucket(hash)];
+            const auto &slot = _slots[displacement < 0 ? -1 - displacement : _slot(hash, displacement)];
+            return slot.hash == hash && _equal(std::string_view(_keys).substr(slot.offset, slot.length), key) ? &slot.value : NULL;
+        }
+
+        /** @brief The number of keys in the table */
+        std::size_t size() const
+        {
+            return _slots.size();
+        }
+
+        /** @brief The number of slots of the table, for diagnostics (equal to `size()`) */
+        std::size_t capacity() const
+        {
+            return _slots.size();
+        }
+    };
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "standard.hpp"
+
+namespace utils
+{
+    /**
+     * @brief An immutable view of a reference-counted string buffer
+     *
+     * Copying a `SharedString` or taking a substring of it is O(1): the result refers to the same buffer. The
+     * buffer is released when the last `SharedString` referring to it is destroyed.
+     */
+    class SharedString
+    {
+    private:
+        std::shared_ptr<std::string> _buffer;
+        std::size_t _offset = 0, _length = 0;
+
+    public:
+        /** @brief Construct an empty string */
+        SharedString() {}
+
+        /** @brief Construct a string holding a copy of `value` */
+        explicit SharedString(const std::string_view &value)
+            : _buffer(std::make_shared<std::string>(value)), _length(value.size()) {}
+
+        /** @brief Construct a string taking over the storage of `value` */
+        explicit SharedString(std::string &&value)
+            : _buffer(std::make_shared<std::string>(std::move(value))), _length(_buffer->size()) {}
+
+        /** @brief The length of this string in bytes */
+        std::size_t size() const
+        {
+            return _length;
+        }
+
+        /** @brief Whether this string is empty */
+        bool empty() const
+        {
+            return _length == 0;
+        }
+
+        /** @brief A view of this string, valid as long as any `SharedString` refers to the same buffer */
+        std::string_view view() const
+        {
+            return _buffer == nullptr ? std::string_view() : std::string_view(_buffer->data() + _offset, _length);
+        }
+
+        /**
+         * @brief Get a substring sharing the same buffer, in O(1)
+         *
+         * @param position The position of the first character
+         * @param count The maximum length of the substring
+         * @return The substring
+         * @throw `std::out_of_range` if `position` is greater than the length of this string
+         */
+        SharedString substr(const std::size_t position, const std::size_t count = std::string_view::npos) const
+        {
+            if (position > _length)
+            {
+                throw std::out_of_range("Substring position is out of range");
+            }
+
+            SharedString result(*this);
+            result._offset += position;
+            result._length = std::min(count, _length - position);
+            return result;
+        }
+
+        /**
+         * @brief Append text to this string
+         *
+         * The buffer is extended in place if no other `SharedString` refers to it and this string ends at the end
+         * of the buffer. Otherwise, the content is first copied to a new buffer with room to grow, so appending
+         * piece by piece takes amortized O(1) per appended byte.
+         *
+         * @param value The text to append
+         */
+        void append(const std::string_view &value)
+        {
+            if (_buffer == nullptr || _buffer.use_count() != 1 || _offset + _length != _buffer->size())
+            {
+                auto buffer = std::make_shared<std::string>();
+                buffer->reserve(2 * (_length + value.size()));
+                buffer->append(view());
+
+                _buffer = buffer;
+                _offset = 0;
+            }
+
+            _buffer->append(value);
+            _length += value.size();
+        }
+    };
+}
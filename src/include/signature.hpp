@@ -0,0 +1,593 @@
+#pragma once
+
+#include "base.hpp"
+
+namespace liteshell
+{
+    /** @brief A file system path argument, checked for characters that Windows does not allow in paths */
+    struct Path
+    {
+        std::string value;
+    };
+
+    /**
+     * @brief A named value of an enumerated argument
+     *
+     * @tparam T The type of the value
+     */
+    template <typename T>
+    struct Choice
+    {
+        const char *name;
+        T value;
+    };
+
+    /**
+     * @brief Describes how the type of an argument member is bound
+     *
+     * - `T`: a required argument
+     * - `std::optional<T>`: an optional argument
+     * - `std::vector<T>`: a variadic argument, with at least 1 value
+     */
+    template <typename T>
+    struct _ArgumentTraits
+    {
+        typedef T value_type;
+        static constexpr bool required = true;
+        static constexpr bool many = false;
+    };
+
+    template <typename T>
+    struct _ArgumentTraits<std::optional<T>>
+    {
+        typedef T value_type;
+        static constexpr bool required = false;
+        static constexpr bool many = false;
+    };
+
+    template <typename T>
+    struct _ArgumentTraits<std::vector<T>>
+    {
+        typedef T value_type;
+        static constexpr bool required = true;
+        static constexpr bool many = true;
+    };
+
+    /*
+     * The checks below run while a signature is constant-evaluated (signatures are declared `static constexpr`).
+     * Reaching a `throw` there is not a constant expression, so an invalid signature fails to compile with an
+     * error pointing at the violated check.
+     */
+
+    constexpr bool _is_word_character(const char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    constexpr bool _is_letter(const char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    constexpr bool _equal(const char *first, const char *second)
+    {
+        while (*first != '\0' && *first == *second)
+        {
+            first++;
+            second++;
+        }
+
+        return *first == *second;
+    }
+
+    constexpr const char *_check_argument_name(const char *name)
+    {
+        if (name[0] == '\0')
+        {
+            throw std::invalid_argument("Argument names must not be empty");
+        }
+
+        for (auto c = name; *c != '\0'; c++)
+        {
+            if (!_is_word_character(*c))
+            {
+                throw std::invalid_argument("Argument names must only contain letters, digits and underscores");
+            }
+        }
+
+        return name;
+    }
+
+    constexpr const char *_check_option_name(const char *name)
+    {
+        if (name[0] != '-')
+        {
+            throw std::invalid_argument("Option names must start with \"-\"");
+        }
+
+        if (name[1] != '-')
+        {
+            if (!_is_letter(name[1]) || name[2] != '\0')
+            {
+                throw std::invalid_argument("Short option names must be a single letter (e.g. \"-v\")");
+            }
+
+            return name;
+        }
+
+        if (name[2] == '\0')
+        {
+            throw std::invalid_argument("Long option names must not be empty");
+        }
+
+        for (auto c = name + 2; *c != '\0'; c++)
+        {
+            if (!_is_letter(*c) && *c != '-' && *c != '_')
+            {
+                throw std::invalid_argument("Long option names must only contain letters, \"-\" and \"_\"");
+            }
+        }
+
+        return name;
+    }
+
+    /** @brief A positional argument of a signature, bound to a member of `A` */
+    template <typename A, typename M>
+    struct _PositionalParameter
+    {
+        typedef typename _ArgumentTraits<M>::value_type value_type;
+
+        const char *name;
+        const char *help;
+        M A::*member;
+        const Choice<value_type> *choices;
+        std::size_t choice_count;
+    };
+
+    /** @brief An option without argument of a signature, bound to a `bool` member of `A` */
+    template <typename A>
+    struct _FlagParameter
+    {
+        const char *name;
+        const char *help;
+        bool A::*member;
+    };
+
+    /** @brief An option with 1 argument of a signature, bound to a `std::optional` member of `A` */
+    template <typename A, typename M>
+    struct _OptionParameter
+    {
+        typedef typename _ArgumentTraits<M>::value_type value_type;
+
+        const char *name;
+        const char *argument;
+        const char *help;
+        M A::*member;
+        const Choice<value_type> *choices;
+        std::size_t choice_count;
+    };
+
+    /**
+     * @brief Declare a positional argument
+     *
+     * @param name The name of the argument
+     * @param help The string describing the argument
+     * @param member The member receiving the value: `T` (required), `std::optional<T>` or `std::vector<T>`
+     */
+    template <typename A, typename M>
+    constexpr _PositionalParameter<A, M> positional(const char *name, const char *help, M A::*member)
+    {
+        return {_check_argument_name(name), help, member, NULL, 0};
+    }
+
+    /**
+     * @brief Declare a positional argument taking one of the given named values
+     *
+     * @param name The name of the argument
+     * @param help The string describing the argument
+     * @param member The member receiving the value
+     * @param choices The accepted values
+     */
+    template <typename A, typename M, std::size_t N>
+    constexpr _PositionalParameter<A, M> positional(
+        const char *name,
+        const char *help,
+        M A::*member,
+        const Choice<typename _ArgumentTraits<M>::value_type> (&choices)[N])
+    {
+        return {_check_argument_name(name), help, member, choices, N};
+    }
+
+    /**
+     * @brief Declare an option without argument
+     *
+     * @param name The name of the option, e.g. `-v` or `--verbose`
+     * @param help The string describing the option
+     * @param member The member set to whether the option is present
+     */
+    template <typename A>
+    constexpr _FlagParameter<A> flag(const char *name, const char *help, bool A::*member)
+    {
+        return {_check_option_name(name), help, member};
+    }
+
+    /**
+     * @brief Declare an option with 1 argument
+     *
+     * @param name The name of the option, e.g. `-s` or `--sort`
+     * @param argument The name of the argument of the option
+     * @param help The string describing the option
+     * @param member The `std::optional` member receiving the value
+     */
+    template <typename A, typename M>
+    constexpr _OptionParameter<A, M> option(const char *name, const char *argument, const char *help, M A::*member)
+    {
+        static_assert(!_ArgumentTraits<M>::required && !_ArgumentTraits<M>::many, "Options must be bound to a std::optional member");
+        return {_check_option_name(name), _check_argument_name(argument), help, member, NULL, 0};
+    }
+
+    /**
+     * @brief Declare an option with 1 argument taking one of the given named values
+     *
+     * @param name The name of the option
+     * @param argument The name of the argument of the option
+     * @param help The string describing the option
+     * @param member The `std::optional` member receiving the value
+     * @param choices The accepted values
+     */
+    template <typename A, typename M, std::size_t N>
+    constexpr _OptionParameter<A, M> option(
+        const char *name,
+        const char *argument,
+        const char *help,
+        M A::*member,
+        const Choice<typename _ArgumentTraits<M>::value_type> (&choices)[N])
+    {
+        static_assert(!_ArgumentTraits<M>::required && !_ArgumentTraits<M>::many, "Options must be bound to a std::optional member");
+        return {_check_option_name(name), _check_argument_name(argument), help, member, choices, N};
+    }
+
+    /**
+     * @brief Convert an argument value to the type of its member
+     *
+     * This is the single conversion path of typed signatures: every failure is reported as an
+     * `std::invalid_argument` naming the argument.
+     *
+     * @param value The value from the command line
+     * @param name The name of the argument, for error messages
+     * @param choices The accepted named values, or `NULL`
+     * @param choice_count The number of accepted named values
+     * @return The converted value
+     */
+    template <typename T>
+    T convert_argument(const std::string &value, const char *name, const Choice<T> *choices, const std::size_t choice_count)
+    {
+        if (choices != NULL)
+        {
+            for (std::size_t i = 0; i < choice_count; i++)
+            {
+                if (value == choices[i].name)
+                {
+                    return choices[i].value;
+                }
+            }
+
+            std::string expected;
+            for (std::size_t i = 0; i < choice_count; i++)
+            {
+                expected += i == 0 ? "\"" : ", \"";
+                expected += choices[i].name;
+                expected += "\"";
+            }
+
+            throw std::invalid_argument(utils::format("Invalid value \"%s\" for \"%s\" (expected one of %s)", value.c_str(), name, expected.c_str()));
+        }
+
+        if constexpr (std::is_same_v<T, std::string>)
+        {
+            return value;
+        }
+        else if constexpr (std::is_same_v<T, Path>)
+        {
+            if (value.empty() || value.find_first_of("<>\"|?*") != std::string::npos)
+            {
+                throw std::invalid_argument(utils::format("Invalid path \"%s\" for \"%s\"", value.c_str(), name));
+            }
+
+            return Path{value};
+        }
+        else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+        {
+            T result = 0;
+            auto [pointer, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+            if (value.empty() || error != std::errc() || pointer != value.data() + value.size())
+            {
+                throw std::invalid_argument(
+                    error == std::errc::result_out_of_range
+                        ? utils::format("Integer \"%s\" for \"%s\" is out of range", value.c_str(), name)
+                        : utils::format("Invalid integer \"%s\" for \"%s\"", value.c_str(), name));
+            }
+
+            return result;
+        }
+        else
+        {
+            static_assert(std::is_enum_v<T>, "Unsupported argument type");
+            throw std::invalid_argument(utils::format("No values are declared for \"%s\"", name));
+        }
+    }
+
+    /**
+     * @brief The typed signature of a command
+     *
+     * Construct with `make_signature`.
+     *
+     * @tparam A The argument struct passed to `TypedCommand::run`
+     * @tparam P The types of the parameters
+     */
+    template <typename A, typename... P>
+    class Signature
+    {
+    private:
+        template <typename M>
+        static void _add(std::vector<PositionalArgument> &positional, CommandConstraint &, const _PositionalParameter<A, M> &parameter)
+        {
+            positional.emplace_back(parameter.name, parameter.help, _ArgumentTraits<M>::many, _ArgumentTraits<M>::required);
+        }
+
+        static void _add(std::vector<PositionalArgument> &, CommandConstraint &constraint, const _FlagParameter<A> &parameter)
+        {
+            constraint.add_option(parameter.name, parameter.help);
+        }
+
+        template <typename M>
+        static void _add(std::vector<PositionalArgument> &, CommandConstraint &constraint, const _OptionParameter<A, M> &parameter)
+        {
+            constraint.add_option(parameter.name, parameter.help, PositionalArgument(parameter.argument, parameter.help, false, true));
+        }
+
+        template <typename M>
+        static ArgumentSlot _slot(const CommandConstraint &constraint, const _PositionalParameter<A, M> &parameter)
+        {
+            return constraint.slot(parameter.name);
+        }
+
+        static ArgumentSlot _slot(const CommandConstraint &constraint, const _FlagParameter<A> &parameter)
+        {
+            return constraint.slot(parameter.name);
+        }
+
+        template <typename M>
+        static ArgumentSlot _slot(const CommandConstraint &constraint, const _OptionParameter<A, M> &parameter)
+        {
+            return constraint.slot(std::string(parameter.name) + " " + parameter.argument);
+        }
+
+        template <typename M>
+        static void _bind(A &arguments, const Context &context, const ArgumentSlot slot, const _PositionalParameter<A, M> &parameter)
+        {
+            typedef _ArgumentTraits<M> traits;
+            if constexpr (traits::many)
+            {
+                for (auto &value : context.get_all(slot))
+                {
+                    (arguments.*parameter.member).push_back(convert_argument(value, parameter.name, parameter.choices, parameter.choice_count));
+                }
+            }
+            else if (context.has(slot))
+            {
+                arguments.*parameter.member = convert_argument(context.get(slot), parameter.name, parameter.choices, parameter.choice_count);
+            }
+        }
+
+        static void _bind(A &arguments, const Context &context, const ArgumentSlot slot, const _FlagParameter<A> &parameter)
+        {
+            arguments.*parameter.member = context.has(slot);
+        }
+
+        template <typename M>
+        static void _bind(A &arguments, const Context &context, const ArgumentSlot slot, const _OptionParameter<A, M> &parameter)
+        {
+            if (context.has(slot))
+            {
+                arguments.*parameter.member = convert_argument(context.get(slot), parameter.name, parameter.choices, parameter.choice_count);
+            }
+        }
+
+    public:
+        /** @brief The parameters of this signature */
+        const std::tuple<P...> parameters;
+
+        constexpr Signature(const std::tuple<P...> &parameters) : parameters(parameters) {}
+
+        /** @brief Build the runtime constraint of this signature */
+        CommandConstraint constraint() const
+        {
+            std::vector<PositionalArgument> positional;
+            CommandConstraint options;
+            std::apply(
+                [&](const auto &...parameter)
+                {
+                    (_add(positional, options, parameter), ...);
+                },
+                parameters);
+
+            CommandConstraint result(positional);
+            for (auto &option : options.get_options_vector())
+            {
+                result.add_option(option);
+            }
+
+            return result;
+        }
+
+        /**
+         * @brief Resolve the slot of each parameter in a constraint built by `constraint()`
+         *
+         * @param constraint The constraint
+         * @return The slots, in the order of the parameters
+         */
+        std::vector<ArgumentSlot> slots(const CommandConstraint &constraint) const
+        {
+            return std::apply(
+                [&constraint](const auto &...parameter)
+                {
+                    return std::vector<ArgumentSlot>{_slot(constraint, parameter)...};
+                },
+                parameters);
+        }
+
+        /**
+         * @brief Convert the arguments of a bound context
+         *
+         * @param context The context, bound to the constraint of this signature
+         * @param slots The slots returned by `slots()`
+         * @return The typed arguments
+         * @throw `std::invalid_argument` if a value cannot be converted
+         */
+        A bind(const Context &context, const std::vector<ArgumentSlot> &slots) const
+        {
+            A arguments{};
+            std::apply(
+                [&](const auto &...parameter)
+                {
+                    std::size_t i = 0;
+                    (_bind(arguments, context, slots[i++], parameter), ...);
+                },
+                parameters);
+
+            return arguments;
+        }
+    };
+
+    /** @brief The names declared by a parameter, for the duplicate check */
+    template <typename A, typename M>
+    constexpr const char *_declared_name(const _PositionalParameter<A, M> &parameter)
+    {
+        return parameter.name;
+    }
+
+    template <typename A>
+    constexpr const char *_declared_name(const _FlagParameter<A> &parameter)
+    {
+        return parameter.name;
+    }
+
+    template <typename A, typename M>
+    constexpr const char *_declared_name(const _OptionParameter<A, M> &parameter)
+    {
+        return parameter.name;
+    }
+
+    /** @brief Whether a parameter is a variadic positional argument, or `-1` if it is not positional */
+    template <typename A, typename M>
+    constexpr int _variadic(const _PositionalParameter<A, M> &)
+    {
+        return _ArgumentTraits<M>::many;
+    }
+
+    template <typename A>
+    constexpr int _variadic(const _FlagParameter<A> &)
+    {
+        return -1;
+    }
+
+    template <typename A, typename M>
+    constexpr int _variadic(const _OptionParameter<A, M> &)
+    {
+        return -1;
+    }
+
+    /**
+     * @brief Declare the typed signature of a command
+     *
+     * Positional arguments are bound in declaration order. Names must be distinct and a variadic argument must
+     * be the last positional argument. Both are checked at compile time when the result is `constexpr`.
+     *
+     * @param parameters The parameters, built with `positional`, `flag` and `option`
+     * @return The signature
+     */
+    template <typename A, typename... P>
+    constexpr Signature<A, P...> make_signature(const P &...parameters)
+    {
+        const char *names[] = {_declared_name(parameters)..., NULL};
+        const int variadic[] = {_variadic(parameters)..., -1};
+        constexpr std::size_t count = sizeof...(P);
+
+        for (std::size_t i = 0; i < count; i++)
+        {
+            for (std::size_t j = 0; j < i; j++)
+            {
+                if (_equal(names[i], names[j]))
+                {
+                    throw std::invalid_argument("Duplicate argument name in signature");
+                }
+            }
+        }
+
+        bool after_variadic = false;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            if (variadic[i] >= 0)
+            {
+                if (after_variadic)
+                {
+                    throw std::invalid_argument("A variadic argument must be the last positional argument");
+                }
+
+                after_variadic = variadic[i] == 1;
+            }
+        }
+
+        return Signature<A, P...>(std::make_tuple(parameters...));
+    }
+
+    /**
+     * @brief Base class for commands declared with a typed signature
+     *
+     * The subclass `D` declares `static constexpr auto signature = liteshell::make_signature<A>(...)` and
+     * implements `run(const Context &, const A &)`. The constraint and the slots of the parameters are computed
+     * once at construction, so converting the arguments of an invocation only indexes the bound context.
+     *
+     * @tparam D The subclass
+     * @tparam A The argument struct
+     */
+    template <typename D, typename A>
+    class TypedCommand : public BaseCommand
+    {
+    private:
+        /** @brief The slot of each parameter of the signature */
+        std::vector<ArgumentSlot> _slots;
+
+    public:
+        /**
+         * @brief Construct a new command with a typed signature
+         *
+         * @param name The name of the command
+         * @param description A short description of the command
+         * @param long_description A long description of the command
+         * @param aliases A list of aliases the command can be invoked under
+         */
+        TypedCommand(
+            const std::string &name,
+            const std::string &description,
+            const std::string &long_description,
+            const std::initializer_list<std::string> &aliases = {})
+            : BaseCommand(name, description, long_description, aliases, D::signature.constraint()),
+              _slots(D::signature.slots(constraint)) {}
+
+        DWORD run(const Context &context) final
+        {
+            return run(context, D::signature.bind(context, _slots));
+        }
+
+        /**
+         * @brief Invoke this command with typed arguments
+         *
+         * @param context The context in which the command is being invoked under.
+         * @param arguments The converted arguments
+         * @return The new errorlevel for the shell.
+         */
+        virtual DWORD run(const Context &context, const A &arguments) = 0;
+    };
+}
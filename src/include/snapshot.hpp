@@ -0,0 +1,341 @@
+#pragma once
+
+#include "converter.hpp"
+#include "finalize.hpp"
+#include "format.hpp"
+
+/** @brief The current version of the environment snapshot format */
+#define LITE_SHELL_SNAPSHOT_VERSION 1
+
+namespace liteshell
+{
+    /**
+     * @brief Binary snapshots of environment variables
+     *
+     * A snapshot file consists of (all integers are little-endian):
+     * - A fixed `Header` identifying the format and its version
+     * - `Header::count` fixed-size `Record`s, one per variable
+     * - A string table holding the names and values referred to by the records
+     *
+     * The checksum in the header covers the records and the string table. Loading a snapshot maps the file into
+     * memory and validates it as a whole, so the records can then be applied in bulk without any per-entry parsing,
+     * see `Environment::load_snapshot`.
+     */
+    namespace snapshot
+    {
+        /** @brief The record flag of an exported variable */
+        const std::uint32_t EXPORTED = 1;
+
+        struct Header
+        {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t count;
+
+            /** @brief The size of the string table in bytes */
+            std::uint64_t strings;
+            std::uint64_t checksum;
+        };
+
+        struct Record
+        {
+            /** @brief The offset of the name in the string table, immediately followed by the value */
+            std::uint64_t offset;
+            std::uint32_t name_length;
+            std::uint32_t value_length;
+            std::uint32_t flags;
+            std::uint32_t reserved;
+        };
+
+        const char MAGIC[8] = {'L', 'S', 'E', 'N', 'V', 'S', 'N', 'P'};
+
+        /** @brief A fast checksum for detecting corruption, consuming 8 bytes per step */
+        std::uint64_t checksum(const char *data, const std::size_t size)
+        {
+            const std::uint64_t prime = 1099511628211ull;
+            std::uint64_t hash = 14695981039346656037ull;
+
+            std::size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                std::uint64_t word;
+                std::memcpy(&word, data + i, 8);
+                hash = (hash ^ word) * prime;
+                hash ^= hash >> 32;
+            }
+
+            for (; i < size; i++)
+            {
+                hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+            }
+
+            return hash;
+        }
+
+        /** @brief Build a snapshot file in memory */
+        class Writer
+        {
+        private:
+            std::vector<Record> _records;
+            std::string _strings;
+
+        public:
+            /**
+             * @brief Add a variable to the snapshot
+             *
+             * @param name The name of the variable
+             * @param value The value of the variable
+             * @param flags The flags of the record (e.g. `EXPORTED`)
+             */
+            void add(const std::string_view &name, const std::string_view &value, const std::uint32_t flags)
+            {
+                if (name.size() > UINT32_MAX || value.size() > UINT32_MAX || _records.size() == UINT32_MAX)
+                {
+                    throw std::runtime_error("Environment is too large for a snapshot");
+                }
+
+                _records.push_back({_strings.size(), static_cast<std::uint32_t>(name.size()), static_cast<std::uint32_t>(value.size()), flags, 0});
+                _strings.append(name);
+                _strings.append(value);
+            }
+
+            /**
+             * @brief Write the snapshot to a file, replacing its content
+             *
+             * @param path The path to the file
+             */
+            void write(const std::string &path) const
+            {
+                const auto records_size = _records.size() * sizeof(Record);
+
+                std::string body(records_size + _strings.size(), '\0');
+                std::memcpy(body.data(), _records.data(), records_size);
+                std::memcpy(body.data() + records_size, _strings.data(), _strings.size());
+
+                Header header;
+                std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+                header.version = LITE_SHELL_SNAPSHOT_VERSION;
+                header.count = static_cast<std::uint32_t>(_records.size());
+                header.strings = _strings.size();
+                header.checksum = checksum(body.data(), body.size());
+
+                auto file = CreateFileW(
+                    utils::utf_convert(path).c_str(),
+                    GENERIC_WRITE,
+                    0,
+                    NULL,
+                    CREATE_ALWAYS,
+                    FILE_ATTRIBUTE_NORMAL,
+                    NULL);
+
+                if (file == INVALID_HANDLE_VALUE)
+                {
+                    throw std::runtime_error(utils::last_error("Error when opening file"));
+                }
+
+                auto _finalize = utils::Finalize(
+                    [&file]()
+                    {
+                        CloseHandle(file);
+                    });
+
+                auto write = [&file](const char *data, std::size_t size)
+                {
+                    while (size > 0)
+                    {
+                        DWORD written;
+                        if (!WriteFile(file, data, static_cast<DWORD>(std::min<std::size_t>(size, 1 << 30)), &written, NULL))
+                        {
+                            throw std::runtime_error(utils::last_error("Error when writing file"));
+                        }
+
+                        data += written;
+                        size -= written;
+                    }
+                };
+
+                write(reinterpret_cast<const char *>(&header), sizeof(header));
+                write(body.data(), body.size());
+            }
+        };
+
+        /** @brief A validated, read-only view of a snapshot file mapped into memory */
+        class Reader
+        {
+        private:
+            HANDLE _file = INVALID_HANDLE_VALUE, _mapping = NULL;
+            const char *_data = NULL;
+
+            const Header *_header = NULL;
+            const Record *_records = NULL;
+            const char *_strings = NULL;
+
+            Reader(const Reader &) = delete;
+            Reader &operator=(const Reader &) = delete;
+
+            void _close()
+            {
+                if (_data != NULL)
+                {
+                    UnmapViewOfFile(_data);
+                }
+                if (_mapping != NULL)
+                {
+                    CloseHandle(_mapping);
+                }
+                if (_file != INVALID_HANDLE_VALUE)
+                {
+                    CloseHandle(_file);
+                }
+            }
+
+            void _open(const std::string &path)
+            {
+                _file = CreateFileW(
+                    utils::utf_convert(path).c_str(),
+                    GENERIC_READ,
+                    FILE_SHARE_READ,
+                    NULL,
+                    OPEN_EXISTING,
+                    FILE_ATTRIBUTE_NORMAL,
+                    NULL);
+
+                if (_file == INVALID_HANDLE_VALUE)
+                {
+                    if (GetLastError() == ERROR_FILE_NOT_FOUND)
+                    {
+                        throw std::invalid_argument("The specified file does not exist");
+                    }
+
+                    throw std::runtime_error(utils::last_error("Error when opening file"));
+                }
+
+                LARGE_INTEGER size;
+                if (!GetFileSizeEx(_file, &size))
+                {
+                    throw std::runtime_error(utils::last_error("Error when reading file size"));
+                }
+
+                // Mapping an empty file fails, so check the size first
+                if (static_cast<std::uint64_t>(size.QuadPart) < sizeof(Header))
+                {
+                    throw std::runtime_error("Not an environment snapshot");
+                }
+
+                _mapping = CreateFileMappingW(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+                if (_mapping == NULL)
+                {
+                    throw std::runtime_error(utils::last_error("Error when mapping file"));
+                }
+
+                _data = static_cast<const char *>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+                if (_data == NULL)
+                {
+                    throw std::runtime_error(utils::last_error("Error when mapping file"));
+                }
+
+                _validate(size.QuadPart);
+            }
+
+            void _validate(const std::uint64_t size)
+            {
+                _header = reinterpret_cast<const Header *>(_data);
+                if (std::memcmp(_header->magic, MAGIC, sizeof(MAGIC)) != 0)
+                {
+                    throw std::runtime_error("Not an environment snapshot");
+                }
+
+                if (_header->version != LITE_SHELL_SNAPSHOT_VERSION)
+                {
+                    throw std::runtime_error(
+                        utils::format("Unsupported snapshot version %u (expected %u)", _header->version, LITE_SHELL_SNAPSHOT_VERSION));
+                }
+
+                const std::uint64_t records_size = static_cast<std::uint64_t>(_header->count) * sizeof(Record);
+                if (size - sizeof(Header) < records_size || size - sizeof(Header) - records_size != _header->strings)
+                {
+                    throw std::runtime_error("Corrupted snapshot: unexpected file size");
+                }
+
+                if (checksum(_data + sizeof(Header), size - sizeof(Header)) != _header->checksum)
+                {
+                    throw std::runtime_error("Corrupted snapshot: checksum mismatch");
+                }
+
+                _records = reinterpret_cast<const Record *>(_data + sizeof(Header));
+                _strings = _data + sizeof(Header) + records_size;
+
+                for (std::uint32_t i = 0; i < _header->count; i++)
+                {
+                    const auto &record = _records[i];
+                    bool valid = record.offset <= _header->strings &&
+                                 static_cast<std::uint64_t>(record.name_length) + record.value_length <= _header->strings - record.offset &&
+                                 record.name_length > 0;
+
+                    // Equivalent to `utils::is_valid_variable`, without the regex
+                    for (std::uint32_t j = 0; valid && j < record.name_length; j++)
+                    {
+                        valid = utils::is_word_character(_strings[record.offset + j]);
+                    }
+
+                    if (!valid)
+                    {
+                        throw std::runtime_error(utils::format("Corrupted snapshot: invalid record %u", i));
+                    }
+                }
+            }
+
+        public:
+            /**
+             * @brief Map a snapshot file and validate it
+             *
+             * @param path The path to the file
+             * @throw `std::runtime_error` if the file is not a valid snapshot
+             */
+            Reader(const std::string &path)
+            {
+                try
+                {
+                    _open(path);
+                }
+                catch (...)
+                {
+                    _close();
+                    throw;
+                }
+            }
+
+            ~Reader()
+            {
+                _close();
+            }
+
+            /** @brief The number of variables in the snapshot */
+            std::size_t size() const
+            {
+                return _header->count;
+            }
+
+            /**
+             * @brief Invoke a function for each variable of the snapshot, in the saved order
+             *
+             * The views passed to `function` point into the mapped file and are valid for the lifetime of this object.
+             *
+             * @param function A callable accepting `(std::string_view name, std::string_view value, std::uint32_t flags)`
+             */
+            template <typename F>
+            void for_each(const F &function) const
+            {
+                for (std::uint32_t i = 0; i < _header->count; i++)
+                {
+                    const auto &record = _records[i];
+                    const char *name = _strings + record.offset;
+                    function(
+                        std::string_view(name, record.name_length),
+                        std::string_view(name + record.name_length, record.value_length),
+                        record.flags);
+                }
+            }
+        };
+    }
+}
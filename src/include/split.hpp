@@ -5,29 +5,165 @@
 namespace utils
 {
     /**
-     * @brief Split a string into tokens using the native method [`CommandLineToArgvW`](https://learn.microsoft.com/en-us/windows/win32/api/shellapi/nf-shellapi-commandlinetoargvw)
+     * @brief Split a command line into tokens, following the rules of
+     * [`CommandLineToArgvW`](https://learn.microsoft.com/en-us/windows/win32/api/shellapi/nf-shellapi-commandlinetoargvw)
      *
-     * @param original The string to split
-     * @return A vector of strings containing the tokens
+     * Tokens are separated by spaces and tabs. Double quotes group characters (including separators) into a single
+     * token, `\"` produces a literal quote and backslashes only need escaping when they precede a quote. As with
+     * `CommandLineToArgvW`, the first token (the program name) is read verbatim up to the next separator, or up to
+     * the closing quote if it starts with one, and the line ends at the first null character.
+     *
+     * Tokens without quotes are returned as slices of `line`. Only tokens that need unfolding are written to
+     * `buffer`, which is reserved once so that the views into it stay valid. Unlike `CommandLineToArgvW`, an empty
+     * line yields no tokens (instead of the path of the current executable).
+     *
+     * @tparam S The string type of `buffer` (e.g. `std::pmr::string` to allocate from an arena)
+     * @tparam A The allocator type of the result
+     * @param line The line to split
+     * @param buffer A side buffer for unfolded tokens. Its previous content is discarded.
+     * @param allocator The allocator of the result
+     * @return The tokens, valid as long as `line` and `buffer` are neither modified nor destroyed
      */
-    std::vector<std::string> split(const std::string &original)
+    template <typename S, typename A = std::allocator<std::string_view>>
+    std::vector<std::string_view, A> tokenize(std::string_view line, S &buffer, const A &allocator = A())
     {
-        auto wstr = utf_convert(original);
+        std::vector<std::string_view, A> tokens(allocator);
+        buffer.clear();
 
-        int size = 0;
-        auto results = CommandLineToArgvW(wstr.c_str(), &size);
-        if (results == NULL)
+        line = line.substr(0, line.find('\0'));
+        if (line.empty())
         {
-            throw std::runtime_error(last_error("CommandLineToArgvW ERROR"));
+            return tokens;
         }
 
-        std::vector<std::string> args(size);
-        for (int i = 0; i < size; i++)
+        const char *data = line.data();
+        const std::size_t size = line.size();
+        auto is_separator = [](const char c)
+        {
+            return c == ' ' || c == '\t';
+        };
+
+        std::size_t i = 0;
+        if (data[0] == '"')
         {
-            args[i] = utf_convert(std::wstring(results[i]));
+            auto end = line.find('"', 1);
+            tokens.push_back(line.substr(1, end == std::string_view::npos ? std::string_view::npos : end - 1));
+            i = end == std::string_view::npos ? size : end + 1;
+        }
+        else
+        {
+            while (i < size && !is_separator(data[i]))
+            {
+                i++;
+            }
+
+            tokens.push_back(line.substr(0, i));
+        }
+
+        while (true)
+        {
+            while (i < size && is_separator(data[i]))
+            {
+                i++;
+            }
+
+            if (i == size)
+            {
+                break;
+            }
+
+            const std::size_t start = i;
+            while (i < size && !is_separator(data[i]) && data[i] != '"')
+            {
+                i++;
+            }
+
+            if (i == size || data[i] != '"')
+            {
+                tokens.push_back(line.substr(start, i - start));
+                continue;
+            }
+
+            // An unfolded token is never longer than its source, so the buffer never reallocates
+            if (buffer.capacity() < size)
+            {
+                buffer.reserve(size);
+            }
+
+            const std::size_t offset = buffer.size();
+            buffer.append(data + start, i - start);
+
+            std::size_t backslashes = 0;
+            while (backslashes < i - start && data[i - backslashes - 1] == '\\')
+            {
+                backslashes++;
+            }
+
+            // The number of quotes seen in the current quoted block (the opening quote included)
+            int quotes = 0;
+            while (i < size && (quotes > 0 || !is_separator(data[i])))
+            {
+                const char c = data[i++];
+                if (c == '\\')
+                {
+                    buffer.push_back(c);
+                    backslashes++;
+                }
+                else if (c == '"')
+                {
+                    // 2n backslashes + quote: n backslashes and a quote delimiter
+                    // 2n + 1 backslashes + quote: n backslashes and a literal quote
+                    buffer.resize(buffer.size() - backslashes / 2);
+                    if (backslashes % 2 == 0)
+                    {
+                        quotes++;
+                    }
+                    else
+                    {
+                        buffer.back() = '"';
+                    }
+
+                    backslashes = 0;
+                    while (i < size && data[i] == '"')
+                    {
+                        if (++quotes == 3)
+                        {
+                            buffer.push_back('"');
+                            quotes = 0;
+                        }
+
+                        i++;
+                    }
+
+                    if (quotes == 2)
+                    {
+                        quotes = 0;
+                    }
+                }
+                else
+                {
+                    buffer.push_back(c);
+                    backslashes = 0;
+                }
+            }
+
+            tokens.push_back(std::string_view(buffer.data() + offset, buffer.size() - offset));
         }
 
-        return args;
+        return tokens;
+    }
+
+    /**
+     * @brief Split a command line into tokens (see `tokenize`)
+     *
+     * @param original The string to split
+     * @return A vector of strings containing the tokens
+     */
+    std::vector<std::string> split(const std::string &original)
+    {
+        std::string buffer;
+        auto tokens = tokenize(original, buffer);
+        return std::vector<std::string>(tokens.begin(), tokens.end());
     }
 
     /** @brief Split a string into tokens using a delimiter */
@@ -54,4 +190,4 @@ namespace utils
 
         return result;
     }
-}
\ No newline at end of file
+}
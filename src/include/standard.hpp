@@ -1,15 +1,28 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
 #include <cctype>
+#include <charconv>
 #include <chrono>
+#include <cmath>
 #include <codecvt>
+#include <cwctype>
+#include <deque>
 #include <fstream>
 #include <iostream>
+#include <list>
+#include <memory_resource>
+#include <numeric>
 #include <optional>
 #include <random>
 #include <sstream>
 #include <stack>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <pathcch.h>
 #include <windows.h>
@@ -251,11 +251,18 @@ namespace liteshell
             return _iterator == _list.end();
         }
 
-        /** @brief Append footer to a script */
-        void append_footer(std::stringstream &stream)
+        /**
+         * @brief Append footer to a script
+         *
+         * @param stream The stream containing the script
+         * @param epilogue A command to run silently after the script reaches its end
+         */
+        void append_footer(std::stringstream &stream, const std::string &epilogue)
         {
             stream << "\n";
             stream << STREAM_EOF << "\n";
+            stream << ECHO_OFF << "\n";
+            stream << epilogue << "\n";
             stream << (_echo ? ECHO_ON : ECHO_OFF) << "\n";
         }
 
@@ -3,37 +3,51 @@
 namespace utils
 {
     /**
-     * @brief Remove characters from the beginning and ending of a string
+     * @brief Remove characters from the beginning and ending of a string, without copying it
      *
      * @param original The original string
      * @param remove The characters to remove
-     * @return The stripped string
+     * @return A view into `original` without the leading and trailing characters
      */
     template <typename... Args>
-    std::string strip(const std::string &original, const Args &...remove)
+    std::string_view strip_view(const std::string_view &original, const Args &...remove)
     {
-        std::vector<char> result;
-        std::set<char> to_remove = {remove...};
-        bool ok = false;
-        for (auto c : original)
+        auto removed = [&remove...](const char c)
+        {
+            return ((c == remove) || ...);
+        };
+
+        std::size_t begin = 0, end = original.size();
+        while (begin < end && removed(original[begin]))
         {
-            if (ok)
-            {
-                result.push_back(c);
-            }
-            else if (to_remove.count(c) == 0)
-            {
-                result.push_back(c);
-                ok = true;
-            }
+            begin++;
         }
 
-        while (!result.empty() && to_remove.count(result.back()) == 1)
+        while (end > begin && removed(original[end - 1]))
         {
-            result.pop_back();
+            end--;
         }
 
-        return std::string(result.begin(), result.end());
+        return original.substr(begin, end - begin);
+    }
+
+    /** @brief Remove spaces, newlines, and carriage returns from the beginning and ending of a string, without copying it */
+    std::string_view strip_view(const std::string_view &original)
+    {
+        return strip_view(original, ' ', '\n', '\r');
+    }
+
+    /**
+     * @brief Remove characters from the beginning and ending of a string
+     *
+     * @param original The original string
+     * @param remove The characters to remove
+     * @return The stripped string
+     */
+    template <typename... Args>
+    std::string strip(const std::string &original, const Args &...remove)
+    {
+        return std::string(strip_view(original, remove...));
     }
 
     /** @brief Remove spaces, newlines, and carriage returns from the beginning and ending of a string */
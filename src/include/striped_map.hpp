@@ -0,0 +1,212 @@
+#pragma once
+
+#include "standard.hpp"
+
+/** @brief The number of independently locked shards of a `StripedMap` */
+#define LITE_SHELL_STRIPED_MAP_SHARDS 16
+
+namespace utils
+{
+    /**
+     * @brief A concurrency-safe hash table keyed by strings
+     *
+     * Keys are distributed over `LITE_SHELL_STRIPED_MAP_SHARDS` shards, each guarded by its own slim reader/writer
+     * lock, so threads working on different keys rarely contend. Lookups of existing keys only take a shared lock.
+     *
+     * Entries are never removed and never move, hence a reference obtained from `find` or `emplace` stays valid for
+     * the lifetime of the table and can be used without any lock (e.g. when `V` is a `std::atomic`). Other values
+     * must only be accessed through `load`, `store` and `for_each`, which hold the lock of the shard.
+     *
+     * @tparam V The value type, which must be default-constructible
+     */
+    template <typename V>
+    class StripedMap
+    {
+    private:
+        struct _Entry
+        {
+            const std::string key;
+            V value{};
+
+            _Entry(const std::string_view &key) : key(key) {}
+        };
+
+        struct alignas(64) _Shard
+        {
+            mutable SRWLOCK lock = SRWLOCK_INIT;
+
+            /** @brief The keys are views into the owned entries */
+            std::unordered_map<std::string_view, std::unique_ptr<_Entry>> entries;
+        };
+
+        class _SharedGuard
+        {
+        private:
+            SRWLOCK &_lock;
+
+        public:
+            _SharedGuard(SRWLOCK &lock) : _lock(lock)
+            {
+                AcquireSRWLockShared(&_lock);
+            }
+
+            ~_SharedGuard()
+            {
+                ReleaseSRWLockShared(&_lock);
+            }
+        };
+
+        class _ExclusiveGuard
+        {
+        private:
+            SRWLOCK &_lock;
+
+        public:
+            _ExclusiveGuard(SRWLOCK &lock) : _lock(lock)
+            {
+                AcquireSRWLockExclusive(&_lock);
+            }
+
+            ~_ExclusiveGuard()
+            {
+                ReleaseSRWLockExclusive(&_lock);
+            }
+        };
+
+        _Shard _shards[LITE_SHELL_STRIPED_MAP_SHARDS];
+
+        StripedMap(const StripedMap &) = delete;
+        StripedMap &operator=(const StripedMap &) = delete;
+
+        _Shard &_shard(const std::string_view &key)
+        {
+            return _shards[std::hash<std::string_view>()(key) % LITE_SHELL_STRIPED_MAP_SHARDS];
+        }
+
+    public:
+        /** @brief Construct an empty table */
+        StripedMap() {}
+
+        /**
+         * @brief Get a pointer to the value of a key
+         *
+         * @param key The key to look up
+         * @return A pointer to the value, or `NULL` if the key does not exist
+         */
+        V *find(const std::string_view &key)
+        {
+            auto &shard = _shard(key);
+            _SharedGuard guard(shard.lock);
+
+            auto iter = shard.entries.find(key);
+            return iter == shard.entries.end() ? NULL : &iter->second->value;
+        }
+
+        /**
+         * @brief Get the value of a key, inserting a default value if the key does not exist
+         *
+         * @param key The key to look up
+         * @param inserted Set to whether a new entry was created (optional)
+         * @return A reference to the value
+         */
+        V &emplace(const std::string_view &key, bool *inserted = NULL)
+        {
+            if (inserted != NULL)
+            {
+                *inserted = false;
+            }
+
+            auto value = find(key);
+            if (value != NULL)
+            {
+                return *value;
+            }
+
+            auto &shard = _shard(key);
+            _ExclusiveGuard guard(shard.lock);
+
+            // Another thread may have inserted the key in the meantime
+            auto iter = shard.entries.find(key);
+            if (iter != shard.entries.end())
+            {
+                return iter->second->value;
+            }
+
+            auto entry = std::make_unique<_Entry>(key);
+            auto &result = entry->value;
+            shard.entries.emplace(entry->key, std::move(entry));
+
+            if (inserted != NULL)
+            {
+                *inserted = true;
+            }
+
+            return result;
+        }
+
+        /**
+         * @brief Copy the value of a key under the lock of its shard
+         *
+         * @param key The key to look up
+         * @param result Set to the value of the key, if it exists
+         * @return Whether the key exists
+         */
+        bool load(const std::string_view &key, V &result)
+        {
+            auto &shard = _shard(key);
+            _SharedGuard guard(shard.lock);
+
+            auto iter = shard.entries.find(key);
+            if (iter == shard.entries.end())
+            {
+                return false;
+            }
+
+            result = iter->second->value;
+            return true;
+        }
+
+        /**
+         * @brief Set the value of a key under the lock of its shard, inserting the key if it does not exist
+         *
+         * @param key The key to update
+         * @param value The new value
+         */
+        void store(const std::string_view &key, const V &value)
+        {
+            auto &shard = _shard(key);
+            _ExclusiveGuard guard(shard.lock);
+
+            auto iter = shard.entries.find(key);
+            if (iter != shard.entries.end())
+            {
+                iter->second->value = value;
+                return;
+            }
+
+            auto entry = std::make_unique<_Entry>(key);
+            entry->value = value;
+            shard.entries.emplace(entry->key, std::move(entry));
+        }
+
+        /**
+         * @brief Invoke a function for each entry of the table, in no particular order
+         *
+         * Each shard is locked while its entries are visited, so `function` must not access this table.
+         *
+         * @param function A callable accepting `(std::string_view key, const V &value)`
+         */
+        template <typename F>
+        void for_each(const F &function) const
+        {
+            for (auto &shard : _shards)
+            {
+                _SharedGuard guard(shard.lock);
+                for (auto &[key, entry] : shard.entries)
+                {
+                    function(key, entry->value);
+                }
+            }
+        }
+    };
+}
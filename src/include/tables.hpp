@@ -162,4 +162,140 @@ namespace utils
             return result;
         }
     };
+
+    /**
+     * @brief Print an ASCII table row by row, without holding all rows in memory
+     *
+     * The layout matches `Table`, but column widths are computed from the first rows only (see `sample`). A later
+     * cell longer than its column is printed in full, at the cost of misaligning that row.
+     */
+    class TableStream
+    {
+    private:
+        std::ostream &_stream;
+        const std::vector<std::string> _headers;
+        std::vector<std::vector<std::string>> _pending;
+        std::vector<std::size_t> _widths;
+        bool _started = false;
+
+        void _print_row(const std::vector<std::string_view> &row)
+        {
+            std::size_t lines = 1;
+            for (std::size_t column = 0; column < row.size(); column++)
+            {
+                if (limits[column] > 0 && row[column].size() > limits[column])
+                {
+                    lines = std::max(lines, (row[column].size() + limits[column] - 1) / limits[column]);
+                }
+            }
+
+            for (std::size_t line = 0; line < lines; line++)
+            {
+                for (std::size_t column = 0; column < row.size(); column++)
+                {
+                    std::string_view chunk;
+                    if (line * limits[column] < row[column].size())
+                    {
+                        chunk = row[column].substr(line * limits[column], limits[column]);
+                    }
+
+                    _stream << ' ' << chunk;
+                    if (chunk.size() + 1 < _widths[column])
+                    {
+                        std::fill_n(std::ostreambuf_iterator<char>(_stream), _widths[column] - chunk.size() - 1, ' ');
+                    }
+
+                    _stream << '|';
+                }
+
+                _stream << '\n';
+            }
+        }
+
+        void _start()
+        {
+            _widths.assign(_headers.size(), 0);
+            auto measure = [this](const std::vector<std::string> &row)
+            {
+                for (std::size_t column = 0; column < row.size(); column++)
+                {
+                    _widths[column] = std::max(_widths[column], 2 + std::min(limits[column], row[column].size()));
+                }
+            };
+
+            measure(_headers);
+            for (auto &row : _pending)
+            {
+                measure(row);
+            }
+
+            _print_row(std::vector<std::string_view>(_headers.begin(), _headers.end()));
+            for (auto &width : _widths)
+            {
+                _stream << std::string(width, '-') << '+';
+            }
+            _stream << '\n';
+
+            for (auto &row : _pending)
+            {
+                _print_row(std::vector<std::string_view>(row.begin(), row.end()));
+            }
+
+            _pending.clear();
+            _started = true;
+        }
+
+    public:
+        /** @brief The characters limit for each column, see `Table::limits` */
+        std::vector<std::size_t> limits;
+
+        /** @brief The number of rows used to compute the column widths */
+        const std::size_t sample;
+
+        /**
+         * @brief Construct a new `TableStream`
+         *
+         * @param stream The stream to print to
+         * @param headers The column headers
+         * @param sample The number of rows used to compute the column widths
+         */
+        TableStream(std::ostream &stream, const std::vector<std::string> &headers, const std::size_t sample)
+            : _stream(stream), _headers(headers), limits(headers.size(), (std::size_t)-1), sample(sample) {}
+
+        /**
+         * @brief Add a new row to the table, which is printed as soon as the column widths are known.
+         *
+         * @param row The values in the row
+         */
+        void add_row(const std::vector<std::string_view> &row)
+        {
+            if (row.size() != _headers.size())
+            {
+                throw std::invalid_argument(format("Attempted to add a row of %d item(s) to a table with %d column(s)", row.size(), _headers.size()));
+            }
+
+            if (_started)
+            {
+                _print_row(row);
+                return;
+            }
+
+            _pending.emplace_back(row.begin(), row.end());
+            if (_pending.size() >= sample)
+            {
+                _start();
+            }
+        }
+
+        /** @brief Print the rows added so far, including the header if no row has been printed yet */
+        void flush()
+        {
+            if (!_started)
+            {
+                _start();
+            }
+
+            _stream << std::flush;
+        }
+    };
 }
\ No newline at end of file
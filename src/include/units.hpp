@@ -37,4 +37,23 @@ namespace utils
 
         return result;
     }
+
+    /**
+     * @brief Formatter for floating-point numbers, using the shortest representation that parses back to the
+     * same value, e.g. 0.1 + 0.2 -> `0.30000000000000004`, 2.5e-7 -> `2.5e-07`
+     *
+     * @param value The number to format
+     * @return The formatted string
+     */
+    std::string real_number(const double value)
+    {
+        char buffer[32];
+        auto [pointer, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        if (error != std::errc())
+        {
+            throw std::runtime_error("Unable to format a floating-point number");
+        }
+
+        return std::string(buffer, pointer);
+    }
 }
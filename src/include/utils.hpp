@@ -277,7 +277,18 @@ namespace utils
      */
     bool is_math_symbol(char c)
     {
-        return c == '+' || c == '-' || c == '*' || c == '/' || c == ' ' || c == '%' || ('0' <= c && c <= '9') || c == '(' || c == ')';
+        return ('0' <= c && c <= '9') || (c != '\0' && std::strchr(" +-*/%()<>=!&|^~?:.", c) != NULL);
+    }
+
+    /**
+     * @brief Whether a character is a word character, i.e. `\w` in a regular expression
+     *
+     * @param c The character to check
+     * @return Whether the character is alphanumeric or an underscore
+     */
+    bool is_word_character(char c)
+    {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
     }
 
     const boost::regex _command_name = boost::regex(R"(^\w+$)");
@@ -391,6 +402,68 @@ namespace utils
         return high;
     }
 
+    /**
+     * @brief Parse a decimal integer, which must span the whole string
+     *
+     * @param value The string to parse
+     * @return The parsed integer
+     * @throw `std::invalid_argument` if the string is not a valid integer
+     */
+    long long parse_integer(const std::string &value)
+    {
+        long long result = 0;
+        auto [pointer, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+        if (value.empty() || error != std::errc() || pointer != value.data() + value.size())
+        {
+            throw std::invalid_argument(format("Invalid integer \"%s\"", value.c_str()));
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Whether a string matches a wildcard pattern, where `*` matches any sequence of characters and `?`
+     * matches any single character
+     *
+     * @param pattern The wildcard pattern
+     * @param text The string to match
+     * @return Whether the whole string matches the pattern
+     */
+    bool glob_match(const std::string_view &pattern, const std::string_view &text)
+    {
+        // Backtrack to the last "*" only, which keeps matching linear in practice
+        std::size_t p = 0, t = 0, star = std::string_view::npos, resume = 0;
+        while (t < text.size())
+        {
+            if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t]))
+            {
+                p++;
+                t++;
+            }
+            else if (p < pattern.size() && pattern[p] == '*')
+            {
+                star = p++;
+                resume = t;
+            }
+            else if (star != std::string_view::npos)
+            {
+                p = star + 1;
+                t = ++resume;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        while (p < pattern.size() && pattern[p] == '*')
+        {
+            p++;
+        }
+
+        return p == pattern.size();
+    }
+
     /** @brief Convert an integer to its hex representation */
     template <typename T, std::enable_if_t<std::is_integral_v<T>, bool> = true>
     std::string to_hex_string(const T &value)
@@ -409,7 +482,7 @@ namespace utils
     std::string to_lowercase(const std::string &str)
     {
         std::string result(str);
-        std::transform(result.begin(), result.end(), result.begin(), tolower);
+        std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
         return result;
     }
 
@@ -2,21 +2,30 @@
 
 #include <all.hpp>
 
+#include "commands/_endlocal.hpp"
 #include "commands/_if.hpp"
 #include "commands/array.hpp"
+#include "commands/arrayop.hpp"
+#include "commands/cache.hpp"
+#include "commands/call.hpp"
+#include "commands/cas.hpp"
 #include "commands/cat.hpp"
 #include "commands/cd.hpp"
 #include "commands/clear.hpp"
 #include "commands/color.hpp"
 #include "commands/date.hpp"
+#include "commands/decr.hpp"
 #include "commands/echo.hpp"
 #include "commands/echoln.hpp"
+#include "commands/endlocal.hpp"
 #include "commands/env.hpp"
 #include "commands/eval.hpp"
 #include "commands/exit.hpp"
+#include "commands/export.hpp"
 #include "commands/for.hpp"
 #include "commands/help.hpp"
 #include "commands/if.hpp"
+#include "commands/incr.hpp"
 #include "commands/jump.hpp"
 #include "commands/kill.hpp"
 #include "commands/ls.hpp"
@@ -26,27 +35,39 @@
 #include "commands/ps.hpp"
 #include "commands/resume.hpp"
 #include "commands/rm.hpp"
+#include "commands/setlocal.hpp"
+#include "commands/share.hpp"
 #include "commands/start.hpp"
+#include "commands/str.hpp"
 #include "commands/suspend.hpp"
 #include "commands/volume.hpp"
 
 void initialize(liteshell::Client *client)
 {
-    client->add_command<_IfCommand>()
+    client->add_command<_EndlocalCommand>()
+        ->add_command<_IfCommand>()
         ->add_command<ArrayCommand>()
+        ->add_command<ArrayopCommand>()
+        ->add_command<CacheCommand>()
+        ->add_command<CallCommand>()
+        ->add_command<CasCommand>()
         ->add_command<CatCommand>()
         ->add_command<CdCommand>()
         ->add_command<ClearCommand>()
         ->add_command<ColorCommand>()
         ->add_command<DateCommand>()
+        ->add_command<DecrCommand>()
         ->add_command<EchoCommand>()
         ->add_command<EcholnCommand>()
+        ->add_command<EndlocalCommand>()
         ->add_command<EnvCommand>()
         ->add_command<EvalCommand>()
         ->add_command<ExitCommand>()
+        ->add_command<ExportCommand>()
         ->add_command<ForCommand>()
         ->add_command<HelpCommand>()
         ->add_command<IfCommand>()
+        ->add_command<IncrCommand>()
         ->add_command<JumpCommand>()
         ->add_command<KillCommand>()
         ->add_command<LsCommand>()
@@ -56,7 +77,11 @@ void initialize(liteshell::Client *client)
         ->add_command<PsCommand>()
         ->add_command<ResumeCommand>()
         ->add_command<RmCommand>()
+        ->add_command<SetlocalCommand>()
+        ->add_command<ShareCommand>()
         ->add_command<StartCommand>()
+        ->add_command<StrCommand>()
         ->add_command<SuspendCommand>()
-        ->add_command<VolumeCommand>();
+        ->add_command<VolumeCommand>()
+        ->compile_commands();
 }
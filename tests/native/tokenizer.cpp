@@ -0,0 +1,123 @@
+#include <all.hpp>
+
+/** @brief The previous implementation of `utils::split`, kept as the reference for the differential check */
+std::vector<std::string> legacy_split(const std::string &original)
+{
+    auto wstr = utils::utf_convert(original);
+
+    int size = 0;
+    auto results = CommandLineToArgvW(wstr.c_str(), &size);
+    if (results == NULL)
+    {
+        throw std::runtime_error(utils::last_error("CommandLineToArgvW ERROR"));
+    }
+
+    std::vector<std::string> args(size);
+    for (int i = 0; i < size; i++)
+    {
+        args[i] = utils::utf_convert(std::wstring(results[i]));
+    }
+
+    LocalFree(results);
+    return args;
+}
+
+/** @brief Show the separators and special characters of a line */
+std::string escape(const std::string &line)
+{
+    std::string result;
+    for (auto c : line)
+    {
+        switch (c)
+        {
+        case '\t':
+            result += "\\t";
+            break;
+        case '\0':
+            result += "\\0";
+            break;
+        default:
+            result += c;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Compare `utils::tokenize` with `CommandLineToArgvW` on random lines built mostly from the characters
+ * that drive the quoting rules
+ *
+ * @return Whether all lines produced the same tokens
+ */
+bool differential_check(const std::size_t count)
+{
+    const std::vector<std::string> alphabet = {" ", "\t", "\"", "\"", "\\", "\\", "a", "b", "-", "\xc3\xa9", "\xe4\xb8\xad", std::string(1, '\0')};
+
+    std::string buffer;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        std::string line;
+        const auto length = utils::random<std::size_t>(1, 24);
+        for (std::size_t j = 0; j < length; j++)
+        {
+            line += alphabet[utils::random<std::size_t>(0, alphabet.size() - 1)];
+        }
+
+        // CommandLineToArgvW returns the path of the current executable for an empty line
+        if (line[0] == '\0')
+        {
+            continue;
+        }
+
+        auto expected = legacy_split(line);
+        auto views = utils::tokenize(line, buffer);
+        auto actual = std::vector<std::string>(views.begin(), views.end());
+        if (actual != expected)
+        {
+            std::cout << "Mismatch for line [" << escape(line) << "]\nCommandLineToArgvW:";
+            for (auto &token : expected)
+            {
+                std::cout << " [" << escape(token) << "]";
+            }
+
+            std::cout << "\ntokenize:";
+            for (auto &token : actual)
+            {
+                std::cout << " [" << escape(token) << "]";
+            }
+
+            std::cout << std::endl;
+            return false;
+        }
+    }
+
+    std::cout << utils::format("Differential check: %u random lines match CommandLineToArgvW", count) << std::endl;
+    return true;
+}
+
+/**
+ * Usage:
+ * - `tokenizer <count>`: run the differential check on `count` random lines
+ * - `tokenizer --tokens`: print the tokens of each line read from stdin, as `[token]` on a single line
+ */
+int main(int argc, char **argv)
+{
+    if (argc > 1 && std::string(argv[1]) == "--tokens")
+    {
+        std::string line, buffer;
+        while (std::getline(std::cin, line))
+        {
+            for (auto &token : utils::tokenize(line, buffer))
+            {
+                std::cout << "[" << token << "]";
+            }
+
+            std::cout << std::endl;
+        }
+
+        return 0;
+    }
+
+    return differential_check(argc > 1 ? std::stoull(argv[1]) : 100000) ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+from __future__ import annotations
+
+import random
+
+from .globals import (
+    assert_match,
+    assert_not_match,
+    execute_command,
+    invalid_argument_test,
+    runtime_error_test,
+)
+
+
+def test_arrayop_1() -> None:
+    arr = random.choices(range(-1000, 1000), k=200)
+    command = f"array a {' '.join(map(str, arr))}\narrayop sum a -s s\narrayop min a -s lo\narrayop max a -s hi\necholn \"[$s $lo $hi]\""
+    stdout, _ = execute_command(command)
+    assert_match(f"[{sum(arr)} {min(arr)} {max(arr)}]", stdout)
+
+
+def test_arrayop_2() -> None:
+    a = random.choices(range(-100, 100), k=50)
+    b = random.choices(range(-100, 100), k=50)
+    command = f"array a {' '.join(map(str, a))}\narray b {' '.join(map(str, b))}\n"
+    command += "arrayop dot a b -s d\narrayop add a b -s c\narrayop mul a b\narrayop scale b -3\n"
+    command += "echoln \"[$d] [$c ${c_0} ${c_49}] [${a_0} ${a_49}] [${b_0} ${b_49}]\""
+    stdout, _ = execute_command(command)
+    dot = sum(x * y for x, y in zip(a, b))
+    assert_match(f"[{dot}] [50 {a[0] + b[0]} {a[49] + b[49]}] [{a[0] * b[0]} {a[49] * b[49]}] [{b[0] * -3} {b[49] * -3}]", stdout)
+
+
+def test_arrayop_3() -> None:
+    stdout, _ = execute_command("array a 1 2 3 4\narrayop prefix-sum a\necholn \"[${a_0} ${a_1} ${a_2} ${a_3}]\"")
+    assert_match("[1 3 6 10]", stdout)
+
+
+def test_arrayop_4() -> None:
+    command = "array a 0 1 2 3 9 10 10 4\narrayop histogram a 2 -s h\necholn \"[$h ${h_0} ${h_1}]\""
+    stdout, _ = execute_command(command)
+    assert_match("[2 5 3]", stdout)
+
+    command = "array a -9223372036854775808 9223372036854775807 0\narrayop histogram a 1 -s h\necholn \"[$h ${h_0}]\""
+    stdout, _ = execute_command(command)
+    assert_match("[1 3]", stdout)
+
+    command = "array a -9223372036854775808 9223372036854775807 0\narrayop histogram a 2 -s h\necholn \"[$h ${h_0} ${h_1}]\""
+    stdout, _ = execute_command(command)
+    assert_match("[2 1 2]", stdout)
+
+
+def test_arrayop_5() -> None:
+    invalid_argument_test("array a 1 2\narrayop sort a")
+    invalid_argument_test("array a 1 2\narrayop dot a")
+    runtime_error_test("array a 1 2\narray b 1 2 3\narrayop add a b")
+    runtime_error_test("array a 1 x\narrayop sum a")
+
+
+def test_arrayop_6() -> None:
+    command = "array a 1 2 3\narrayop scale a 2\neval -s a_1 7\narrayop sum a -s s\necholn \"[$a ${a_0} ${a_1} ${a_2} $s]\""
+    stdout, _ = execute_command(command)
+    assert_match("[3 2 7 6 15]", stdout)
+
+    command = "array a 5 6 7 8\narrayop prefix-sum a -s p\neval -s p 2\necholn \"[$p ${p_0} ${p_3}]\""
+    stdout, _ = execute_command(command)
+    assert_match("[2 5 26]", stdout)
+
+    command = "array a 1 2\narrayop scale a 3\nsetlocal\neval -s a_0 9\narrayop scale a 10 -s b\n"
+    command += "echoln \"[${a_0} ${a_1} ${b_0} ${b_1}]\"\nendlocal\necholn \"[${a_0} ${a_1} ${b_0}]\""
+    stdout, _ = execute_command(command)
+    assert_match("[9 6 90 60]", stdout)
+    assert_match("[3 6 ]", stdout)
+
+
+def test_arrayop_7() -> None:
+    command = "array liteshell_a 1 2 3 4\nexport liteshell_a_1\narrayop histogram liteshell_a 2\n"
+    command += "printenv liteshell_a_1\nenv liteshell_a --format tsv"
+    stdout, _ = execute_command(command)
+    assert_match("liteshell_a_1=2", stdout)
+    assert_match("liteshell_a\t2\nliteshell_a_0\t2\nliteshell_a_1\t2\nliteshell_a_2\t3\nliteshell_a_3\t4\n", stdout.replace("\r\n", "\n"))
+    assert_not_match("liteshell_a_1\t2\nliteshell_a_1", stdout.replace("\r\n", "\n"))
+
+
+def test_arrayop_8() -> None:
+    _, stderr = runtime_error_test("array a 1 2\narrayop scale a 2\nincr a_1")
+    assert_match("Variable \"a_1\" is assigned", stderr)
+
+    stdout, _ = execute_command("incr b_1\narray b 1 2\narrayop scale b 2\neval -s b_0 5\necholn \"[${b_0} ${b_1} ${b_2}]\"")
+    assert_match("[5 4 ]", stdout)
+
+
+def test_arrayop_9() -> None:
+    command = "array a 1 2 3\narrayop scale a 2\neval -ms s \"a_0 + a_2\"\nstr join a - -s j\necholn \"[$s|$j]\"\n"
+    command += "arrayop scale a 5\nsetlocal\necholn \"[${a_0} ${a_2}]\"\nendlocal\necholn \"[${a_1}]\""
+    stdout, _ = execute_command(command)
+    assert_match("[8|2-4-6]", stdout)
+    assert_match("[10 30]", stdout)
+    assert_match("[20]", stdout)
@@ -0,0 +1,37 @@
+from __future__ import annotations
+
+import re
+
+from .globals import execute_command
+
+
+def statistic(stdout: str, name: str, /) -> str:
+    match = re.search(rf"{name}\s*\|\s*(\S+)", stdout)
+    assert match is not None
+    return match.group(1)
+
+
+def test_cache_1() -> None:
+    stdout, _ = execute_command("echoln foo\necholn foo\necholn foo\ncache")
+    assert stdout.count("foo") == 3
+    assert statistic(stdout, "Hits") == "2"
+    assert statistic(stdout, "Entries") == "2/256"
+
+
+def test_cache_2() -> None:
+    # Lines with variable references are resolved again on every run
+    stdout, _ = execute_command("eval 1 -s x\necholn \"value $x\"\neval 2 -s x\necholn \"value $x\"\neval 1 -s x\necholn \"value $x\"")
+    assert re.findall(r"value \d", stdout) == ["value 1", "value 2", "value 1"]
+
+
+def test_cache_3() -> None:
+    stdout, _ = execute_command("echoln foo\necholn bar\ncache --clear\ncache")
+    assert statistic(stdout, "Entries") == "1/256"
+
+
+def test_cache_4() -> None:
+    # Loop lines with variable references are not cached, so they do not evict the stable entries
+    stdout, _ = execute_command("echoln foo\nfor i 0 300\neval -ms j \"$i + 1\"\nendfor\necholn foo\necholn \"[$j]\"\ncache")
+    assert "[300]" in stdout
+    assert statistic(stdout, "Evictions") == "0"
+    assert int(statistic(stdout, "Entries").split("/")[0]) < 16
@@ -0,0 +1,75 @@
+from __future__ import annotations
+
+from pathlib import Path
+
+from .globals import (
+    assert_match,
+    assert_not_match,
+    execute_command,
+    invalid_argument_test,
+    runtime_error_test,
+)
+
+
+def test_env_save_load(tmp_path: Path) -> None:
+    snapshot = tmp_path / "snapshot.bin"
+    command = "eval -s liteshell_x 42\neval -s liteshell_y \"Hello World\"\nexport liteshell_y\n"
+    command += f"setlocal\neval -s liteshell_x 7\nenv save \"{snapshot}\""
+    execute_command(command)
+
+    stdout, _ = execute_command(f"env load \"{snapshot}\"\necholn \"[$liteshell_x|$liteshell_y]\"\nprintenv liteshell_y")
+    assert_match("[7|Hello World]", stdout)
+    assert_match("liteshell_y=Hello World", stdout)
+
+
+def test_env_corrupted(tmp_path: Path) -> None:
+    snapshot = tmp_path / "snapshot.bin"
+    execute_command(f"eval -s liteshell_x 42\nenv save \"{snapshot}\"")
+
+    data = bytearray(snapshot.read_bytes())
+    data[-1] ^= 1
+    snapshot.write_bytes(bytes(data))
+
+    _, stderr = runtime_error_test(f"env load \"{snapshot}\"")
+    assert_match("checksum mismatch", stderr)
+
+    snapshot.write_bytes(b"Hello World")
+    _, stderr = runtime_error_test(f"env load \"{snapshot}\"")
+    assert_match("Not an environment snapshot", stderr)
+
+
+def test_env_invalid() -> None:
+    invalid_argument_test("env save")
+    invalid_argument_test("env load")
+    invalid_argument_test("env abc file")
+    invalid_argument_test("env --format xml")
+    invalid_argument_test("env load does_not_exist.bin")
+
+
+def test_env_large_value() -> None:
+    chunk = "x" * 70
+    command = "\n".join(f"str append liteshell_x {chunk}" for _ in range(30))
+    command += "\nsetlocal\nstr append liteshell_x !\nstr len $liteshell_x -s liteshell_n\necholn \"[$liteshell_n]\"\nendlocal"
+    command += "\nstr len $liteshell_x -s liteshell_n\necholn \"[$liteshell_n]\"\nenv"
+    stdout, _ = execute_command(command)
+    assert_match("[2101]", stdout)
+    assert_match("[2100]", stdout)
+    assert_match("(2100 bytes)", stdout)
+
+
+def test_env_filter() -> None:
+    command = "eval -s liteshell_a 1\neval -s liteshell_b 2\neval -s other_c 3\n"
+    stdout, _ = execute_command(command + "env liteshell_ --names-only")
+    assert_match("liteshell_a", stdout)
+    assert_match("liteshell_b", stdout)
+    assert_not_match("other_c", stdout)
+
+    stdout, _ = execute_command(command + "env --glob \"*_?\" --format tsv")
+    assert_match("liteshell_a\t1", stdout)
+    assert_match("other_c\t3", stdout)
+    assert_not_match("PATH", stdout)
+
+
+def test_env_tsv_escape() -> None:
+    stdout, _ = execute_command("str replace abc b \"\t\" -s liteshell_x\nenv liteshell_x --format tsv")
+    assert_match("liteshell_x\ta\\tc", stdout)
@@ -3,7 +3,9 @@ from __future__ import annotations
 from .globals import (
     argument_missing_test,
     assert_match,
+    assert_not_match,
     execute_command,
+    invalid_argument_test,
     runtime_error_test,
     unrecognized_option_test,
 )
@@ -32,7 +34,7 @@ def test_eval_5() -> None:
 
 
 def test_eval_7() -> None:
-    unrecognized_option_test("eval -a")
+    unrecognized_option_test("eval -x")
 
 
 def test_eval_8() -> None:
@@ -89,3 +91,141 @@ def test_eval_18() -> None:
 
 def test_eval_19() -> None:
     argument_missing_test("eval 2 -s")
+
+
+def test_eval_20() -> None:
+    command = "eval -m \"100 % 7 * 3\"\neval -m \"100 % 7 * 3\"\neval -m \"100 % 7 * 3\""
+    stdout, _ = execute_command(command)
+    assert stdout.count("6\n") == 3
+
+
+def test_eval_21() -> None:
+    runtime_error_test("eval \"" + "1 + (" * 200 + "1" + ")" * 200 + "\" -m")
+
+
+def test_eval_22() -> None:
+    command = "eval -s div 7\neval -s n \" -50 \"\neval -m \"div * div + n\"\neval -ms div \"div + 1\"\necholn $div"
+    stdout, _ = execute_command(command)
+    assert_match("-1\n", stdout)
+    assert_match("8\n", stdout)
+
+
+def test_eval_23() -> None:
+    runtime_error_test("eval -s x abc\neval -m \"x + 1\"")
+
+
+def test_eval_24() -> None:
+    runtime_error_test("eval -m \"2x + 1\"")
+
+
+def test_eval_25() -> None:
+    expressions = {
+        "1 < 2 && 3 >= 3": 1,
+        "0 || 5": 1,
+        "!0 + !7 + ~5": -5,
+        "6 & 3 | 8 ^ 1": 11,
+        "1 << 10 >> 2": 256,
+        "2 + 3 == 5 != 0": 1,
+        "0 ? 1 : 2 ? 3 : 4": 3,
+        "(1 ? 0 : 1) ? 5 : -(2 + 3) * 2": -10,
+    }
+    for expression, expected in expressions.items():
+        stdout, _ = execute_command(f"eval -m \"{expression}\"")
+        assert_match(f"{expected}\n", stdout)
+
+
+def test_eval_26() -> None:
+    # The right operand of a short-circuiting operator is not evaluated
+    command = "eval -ms a \"0 && 1 / 0\"\neval -ms b \"1 || undefined_variable\"\neval -ms c \"1 ? 2 : 1 % 0\"\necholn \"[$a $b $c]\""
+    stdout, _ = execute_command(command)
+    assert_match("[0 1 2]", stdout)
+
+
+def test_eval_27() -> None:
+    for expression in ("1 ? 2", "1 = 1", "1 << 64", "1 2", "a &&"):
+        runtime_error_test(f"eval -m \"{expression}\"")
+
+
+def test_eval_28() -> None:
+    expressions = {
+        "0.1 + 0.2": "0.30000000000000004",
+        "7 / 2": "3.5",
+        "1.5e3 * 2": "3000",
+        "-(2.5 - 0.5) * 1e-7": "-2e-07",
+        "7.5 % 2": "1.5",
+        "1 / 3 > 0.3 && 2.0 == 2": "1",
+    }
+    for expression, expected in expressions.items():
+        stdout, _ = execute_command(f"eval -f \"{expression}\" -s result\necholn \"[$result]\"")
+        assert_match(f"[{expected}]", stdout)
+
+
+def test_eval_29() -> None:
+    command = "eval -s done 37\neval -s total 120\neval -fs rate \"done / total * 100\"\necholn \"[$rate]\"\neval -f \"rate * 2\""
+    stdout, _ = execute_command(command)
+    assert_match("[30.833333333333336]", stdout)
+    assert_match("61.66666666666667", stdout)
+
+
+def test_eval_30() -> None:
+    for command in ("eval -f \"3 & 1\"", "eval -f \"1 / 0\"", "eval -f \"1.2.3\"", "eval -m \"1.5\""):
+        runtime_error_test(command)
+
+
+def test_eval_31() -> None:
+    command = "eval -s out start\nsetlocal\neval -a out \"x,\"\neval -a out \"-\"\neval -ma out \"6 * 7\"\necholn \"[$out]\"\nendlocal\n"
+    command += "str append out \"!\"\nstr append fresh abc\necholn \"[$out|$fresh]\""
+    stdout, _ = execute_command(command)
+    assert_match("[startx,-42]", stdout)
+    assert_match("[start!|abc]", stdout)
+
+
+def test_eval_32() -> None:
+    invalid_argument_test("eval abc -a x -s y")
+
+
+def test_eval_33() -> None:
+    stdout, _ = execute_command("eval -ms x \"3 * 4\"\necholn \"[$x]\"")
+    assert_match("[12]", stdout)
+
+    invalid_argument_test("eval -mm 1")
+    invalid_argument_test("eval -m -ms x 1")
+
+
+def test_eval_34() -> None:
+    _, stderr = invalid_argument_test("eval -f -m \"1 / 2\"")
+    assert_match("-f and -m cannot be used together", stderr)
+
+    # Invalid combinations are rejected before prompting for input
+    stdout, _ = invalid_argument_test("eval \"Prompt: \" -p -a x -s y")
+    assert_not_match("Prompt: ", stdout)
+
+    stdout, _ = invalid_argument_test("eval \"Prompt: \" -p -s x.y")
+    assert_not_match("Prompt: ", stdout)
+
+
+def test_eval_35() -> None:
+    _, stderr = runtime_error_test("eval -m \"(-9223372036854775807 - 1) / -1\"")
+    assert_match("overflow", stderr)
+
+    for expression in (
+        "9223372036854775807 + 1",
+        "-9223372036854775807 - 2",
+        "4611686018427387904 * 2",
+        "-(-9223372036854775807 - 1)",
+    ):
+        _, stderr = runtime_error_test(f"eval -m \"{expression}\"")
+        assert_match("integer overflow", stderr)
+
+    command = "eval -ms a \"(-9223372036854775807 - 1) % -1\"\neval -ms b \"7 / -1\"\neval -ms c \"7 % -1\"\necholn \"[$a $b $c]\""
+    stdout, _ = execute_command(command)
+    assert_match("[0 -7 0]", stdout)
+
+
+def test_eval_36() -> None:
+    for expression in ("9223372036854775808", "-9223372036854775808", "99999999999999999999 - 1"):
+        _, stderr = runtime_error_test(f"eval -m \"{expression}\"")
+        assert_match("integer overflow", stderr)
+
+    stdout, _ = execute_command("eval -m 9223372036854775807")
+    assert_match("9223372036854775807", stdout)
@@ -3,7 +3,9 @@ from __future__ import annotations
 import random
 
 from .globals import (
+    assert_match,
     execute_command,
+    invalid_argument_test,
     too_many_positional_arguments_test,
     unrecognized_option_test,
 )
@@ -25,3 +27,11 @@ def test_exit_3() -> None:
 
 def test_exit_4() -> None:
     too_many_positional_arguments_test("exit foo bar")
+
+
+def test_exit_5() -> None:
+    _, stderr = invalid_argument_test("exit abc")
+    assert_match("Invalid integer \"abc\" for \"exitcode\"", stderr)
+
+    _, stderr = invalid_argument_test("exit 99999999999")
+    assert_match("out of range", stderr)
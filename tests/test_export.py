@@ -0,0 +1,46 @@
+from __future__ import annotations
+
+from .globals import (
+    assert_match,
+    assert_not_match,
+    execute_command,
+    invalid_argument_test,
+)
+
+
+def test_export_1() -> None:
+    stdout, _ = execute_command("eval -s liteshell_x 1\nprintenv liteshell_x\nexport liteshell_x\nprintenv liteshell_x")
+    assert_match("liteshell_x=\n", stdout)
+    assert_match("liteshell_x=1\n", stdout)
+
+
+def test_export_2() -> None:
+    command = "eval -s liteshell_x 1\nexport liteshell_x\neval -s liteshell_x 2\nprintenv liteshell_x\n"
+    command += "setlocal\neval -s liteshell_x 3\nprintenv liteshell_x\nendlocal\nprintenv liteshell_x\n"
+    command += "export -n liteshell_x\nprintenv liteshell_x"
+    stdout, _ = execute_command(command)
+    assert stdout.count("liteshell_x=2\n") == 2
+    assert_match("liteshell_x=3\n", stdout)
+    assert_match("liteshell_x=\n", stdout)
+
+
+def test_export_3() -> None:
+    stdout, _ = execute_command("eval -s b 2\neval -s a 1\nexport b a\nexport")
+    assert_match("a=1\nb=2\n", stdout)
+
+
+def test_export_4() -> None:
+    stdout, _ = execute_command("eval -s liteshell_x 1\nexport liteshell_x\nexport -n liteshell_x\nexport")
+    assert_not_match("liteshell_x", stdout)
+
+
+def test_export_5() -> None:
+    invalid_argument_test("export a-b")
+
+
+def test_export_6() -> None:
+    command = "eval -s liteshell_x a\nexport liteshell_x\neval -a liteshell_x b\neval -a liteshell_x c\nprintenv liteshell_x\n"
+    command += "eval -a liteshell_x d\nexport -n liteshell_x\nprintenv liteshell_x"
+    stdout, _ = execute_command(command)
+    assert_match("liteshell_x=abc\n", stdout)
+    assert_not_match("liteshell_x=abcd", stdout)
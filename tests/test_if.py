@@ -0,0 +1,34 @@
+from __future__ import annotations
+
+from .globals import (
+    argument_missing_test,
+    assert_match,
+    assert_not_match,
+    execute_command,
+)
+
+
+def test_if_1() -> None:
+    command = "eval -s n 12\nif -m \"n > 0 && n % 2 == 0 && n % 3 == 0\"\n    echoln yes\nelse\n    echoln no\nendif"
+    stdout, _ = execute_command(command)
+    assert_match("yes", stdout)
+    assert_not_match("no", stdout)
+
+
+def test_if_2() -> None:
+    command = "eval -s n 9\nif -m \"n % 2 == 0 || n < 0\"\n    echoln yes\nelse\n    echoln no\nendif"
+    stdout, _ = execute_command(command)
+    assert_match("no", stdout)
+    assert_not_match("yes", stdout)
+
+
+def test_if_3() -> None:
+    argument_missing_test("if abc")
+
+
+def test_if_4() -> None:
+    command = "eval -s ratio 0.75\nif -f ratio > 0.5\n    echoln high\nelse\n    echoln low\nendif\nif -f \"ratio * 2 == 1.5\"\n    echoln exact\nendif"
+    stdout, _ = execute_command(command)
+    assert_match("high", stdout)
+    assert_match("exact", stdout)
+    assert_not_match("low", stdout)
@@ -0,0 +1,56 @@
+from __future__ import annotations
+
+from .globals import (
+    argument_missing_test,
+    assert_match,
+    execute_command,
+    invalid_argument_test,
+    runtime_error_test,
+)
+
+
+def test_incr_decr() -> None:
+    stdout, _ = execute_command("incr liteshell_n\nincr liteshell_n 10\ndecr liteshell_n 3\necholn \"[$liteshell_n]\"")
+    assert_match("[8]", stdout)
+
+    stdout, _ = execute_command("decr liteshell_n\neval -m \"liteshell_n * 2\"")
+    assert_match("-2", stdout)
+
+
+def test_cas() -> None:
+    command = "cas liteshell_n 0 5\necholn \"[$errorlevel|$liteshell_n]\"\n"
+    command += "cas liteshell_n 0 7\necholn \"[$errorlevel|$liteshell_n]\""
+    stdout, _ = execute_command(command)
+    assert_match("[0|5]", stdout)
+    assert_match("[1|5]", stdout)
+
+
+def test_counter_shadowed() -> None:
+    runtime_error_test("eval -s liteshell_n 1\nincr liteshell_n")
+
+
+def test_counter_invalid() -> None:
+    invalid_argument_test("incr liteshell_n abc")
+    invalid_argument_test("incr \"a b\"")
+    argument_missing_test("cas liteshell_n 1")
+
+
+def test_share() -> None:
+    stdout, _ = execute_command("share liteshell_s \"hello world\"\necholn \"[$liteshell_s]\"\nshare liteshell_s bye\necholn \"[$liteshell_s]\"")
+    assert_match("[hello world]", stdout)
+    assert_match("[bye]", stdout)
+
+    stdout, _ = execute_command("share liteshell_s 1\nsetlocal\neval -s liteshell_s 2\necholn \"[$liteshell_s]\"\nendlocal\necholn \"[$liteshell_s]\"")
+    assert_match("[2]", stdout)
+    assert_match("[1]", stdout)
+
+
+def test_share_shadowed() -> None:
+    runtime_error_test("eval -s liteshell_s 1\nshare liteshell_s 2")
+    runtime_error_test("incr liteshell_s\nshare liteshell_s 2")
+    runtime_error_test("share liteshell_s 2\nincr liteshell_s")
+
+
+def test_share_invalid() -> None:
+    invalid_argument_test("share \"a b\" 1")
+    argument_missing_test("share liteshell_s")
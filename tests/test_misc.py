@@ -2,10 +2,12 @@ from __future__ import annotations
 
 import os
 import random
+import re
 import shutil
 from .globals import (
     assert_match,
     command_not_found_test,
+    environment_resolve_error_test,
     execute_command,
     root_dir,
 )
@@ -16,6 +18,11 @@ def test_no_command() -> None:
     command_not_found_test("abcxyz/")
 
 
+def test_no_command_suggestion() -> None:
+    _, stderr = command_not_found_test("ecoh hello")
+    assert_match("Did you mean \"echo\"?", stderr)
+
+
 def test_escape() -> None:
     stdout, _ = execute_command("echoln \"$$Hello World$$\"")
     assert_match("$Hello World$", stdout)
@@ -40,3 +47,26 @@ def test_mutable_path() -> None:
     finally:
         shutil.move(root_dir / dirname / "hello123.exe", root_dir / "build" / "hello.exe")
         os.rmdir(root_dir / dirname)
+
+
+def test_self_reference() -> None:
+    environment_resolve_error_test("eval -s x $$x\necholn $x")
+
+
+def test_variable_prefix() -> None:
+    stdout, _ = execute_command("eval -s x 1\neval -s x_1 2\necholn \"$x $x_1 ${x}_1\"")
+    assert_match("1 2 1_1", stdout)
+
+
+def test_dynamic_variables() -> None:
+    stdout, _ = execute_command("echoln \"[$epoch|$time_ns|$random|$jobs]\"")
+    match = re.search(r"\[(\d+)\|(\d+)\|(\d+)\|(\d+)\]", stdout)
+    assert match is not None
+
+    assert 0 <= int(match.group(3)) <= 32767
+    assert int(match.group(4)) == 0
+
+
+def test_dynamic_variable_shadowing() -> None:
+    stdout, _ = execute_command("eval -s random abc\necholn \"[$random]\"")
+    assert_match("[abc]", stdout)
@@ -36,6 +36,15 @@ def test_script_prime() -> None:
         assert_not_match("@ON", stdout)
 
 
+def test_script_prime_identifiers() -> None:
+    for value in range(-20, 100):
+        stdout, _ = execute_command(f"tests/prime_identifiers\n{value}")
+        if is_prime(value):
+            assert_match(f"{value} is a prime", stdout)
+        else:
+            assert_match(f"{value} is not a prime", stdout)
+
+
 def test_script_reverse() -> None:
     for _ in range(20):
         arr = random.choices(range(-50, 100), k=40)
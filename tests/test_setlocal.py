@@ -0,0 +1,59 @@
+from __future__ import annotations
+
+from .globals import (
+    assert_match,
+    assert_not_match,
+    execute_command,
+    runtime_error_test,
+)
+
+
+def test_setlocal_1() -> None:
+    command = "eval -s x 1\nsetlocal\neval -s x 2\neval -s y 3\necholn \"$x $y\"\nendlocal\necholn \"[$x $y]\""
+    stdout, _ = execute_command(command)
+    assert_match("2 3", stdout)
+    assert_match("[1 ]", stdout)
+
+
+def test_setlocal_2() -> None:
+    command = "eval -s x 0\n"
+    for i in range(1, 10):
+        command += f"setlocal\neval -s x {i}\neval -s x_{i} {i}\n"
+
+    command += "echoln \"$x ${x_1} ${x_5} ${x_9}\"\n"
+    for _ in range(1, 10):
+        command += "endlocal\n"
+
+    command += "echoln \"[$x ${x_1} ${x_5} ${x_9}]\""
+    stdout, _ = execute_command(command)
+    assert_match("9 1 5 9", stdout)
+    assert_match("[0   ]", stdout)
+
+
+def test_setlocal_3() -> None:
+    runtime_error_test("endlocal")
+
+
+def test_call_1() -> None:
+    stdout, _ = execute_command("eval -s outer 7\ncall tests/scope-1\necholn \"after: [$inner]\"")
+    assert_match("inner = 42, outer = 7", stdout)
+    assert_match("after: []", stdout)
+
+
+def test_call_2() -> None:
+    stdout, _ = execute_command("eval -s outer 7\ntests/scope-1\necholn \"after: [$inner]\"")
+    assert_match("inner = 42, outer = 7", stdout)
+    assert_match("after: [42]", stdout)
+
+
+def test_call_3() -> None:
+    stdout, _ = execute_command("tests/scope-2\necholn \"after: [$leaked]\"")
+    assert_match("leaked = 1", stdout)
+    assert_match("after: []", stdout)
+    assert_not_match("_endlocal", stdout)
+
+
+def test_call_4() -> None:
+    stdout, stderr = execute_command("call tests/fail\necholn \"errorlevel: [$errorlevel] [$ok]\"", no_stderr=False)
+    assert_match("errorlevel: [900] []", stdout)
+    assert_match("division by zero", stderr)
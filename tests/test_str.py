@@ -0,0 +1,45 @@
+from __future__ import annotations
+
+from .globals import (
+    assert_match,
+    execute_command,
+    invalid_argument_test,
+)
+
+
+def test_str_1() -> None:
+    command = "str len \"Hello, world\" -s a\nstr sub \"Hello, world\" 7 -s b\nstr sub \"Hello, world\" -5 3 -s c\n"
+    command += "str find \"Hello, world\" o -s d\nstr find \"Hello, world\" xyz -s e\necholn \"[$a|$b|$c|$d|$e]\""
+    stdout, _ = execute_command(command)
+    assert_match("[12|world|wor|4|-1]", stdout)
+
+
+def test_str_2() -> None:
+    command = "str replace \"a.b.c\" . \"::\" -s a\nstr replace \"x=1, y=22\" \"(\\w)=(\\d+)\" \"$$2$$1\" -r -s b\n"
+    command += "str find \"abc123\" \"\\d\" -r -s c\necholn \"[$a|$b|$c]\""
+    stdout, _ = execute_command(command)
+    assert_match("[a::b::c|1x, 22y|3]", stdout)
+
+
+def test_str_3() -> None:
+    command = "str split \"a,b,,c\" , -s arr\nstr join arr \" + \" -s joined\necholn \"[$arr|${arr_2}|$joined]\"\n"
+    command += "str split \"1  2 3\" \" +\" -r -s nums\necholn \"[$nums|${nums_1}]\""
+    stdout, _ = execute_command(command)
+    assert_match("[4||a + b +  + c]", stdout)
+    assert_match("[3|2]", stdout)
+
+
+def test_str_4() -> None:
+    command = "str upper \"MiXeD 1\" -s a\nstr lower \"MiXeD 1\" -s b\nstr trim \"   padded  \" -s c\necholn \"[$a|$b|$c]\""
+    stdout, _ = execute_command(command)
+    assert_match("[MIXED 1|mixed 1|padded]", stdout)
+
+    # Bytes outside ASCII (here UTF-8) are left unchanged
+    stdout, _ = execute_command("str upper \"caf\u00e9 \u00c9t\u00e9\" -s a\nstr lower \"CAF\u00c9 \u00e9T\u00c9\" -s b\necholn \"[$a|$b]\"")
+    assert_match("[CAF\u00e9 \u00c9T\u00e9|caf\u00c9 \u00e9t\u00c9]", stdout)
+
+
+def test_str_5() -> None:
+    invalid_argument_test("str reverse abc")
+    invalid_argument_test("str sub abc")
+    invalid_argument_test("str split abc \"\"")
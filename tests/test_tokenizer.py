@@ -0,0 +1,39 @@
+from __future__ import annotations
+
+import subprocess
+from typing import List
+
+from .globals import assert_match, build_dir, root_dir
+
+
+tokenizer = build_dir / "tests" / "tokenizer.exe"
+
+
+def tokenize(*lines: str) -> List[str]:
+    process = subprocess.run(
+        [tokenizer, "--tokens"],
+        cwd=root_dir,
+        input="".join(f"{line}\n" for line in lines).encode("utf-8"),
+        capture_output=True,
+    )
+    assert process.returncode == 0
+    return process.stdout.decode("utf-8").replace("\r", "").split("\n")[:-1]
+
+
+def test_tokenizer_differential() -> None:
+    process = subprocess.run([tokenizer, "100000"], cwd=root_dir, capture_output=True)
+    stdout = process.stdout.decode("utf-8")
+    assert process.returncode == 0, stdout
+    assert_match("100000 random lines match CommandLineToArgvW", stdout)
+
+
+def test_tokenizer_empty() -> None:
+    # Unlike CommandLineToArgvW, which returns the path of the current executable
+    assert tokenize("", "\0echo") == ["", ""]
+
+
+def test_tokenizer_quotes() -> None:
+    assert tokenize("echo \"hello world\" a\\\\\\\"b \"\"", "cd \"C:\\Program Files\\\\\"") == [
+        "[echo][hello world][a\\\"b][]",
+        "[cd][C:\\Program Files\\]",
+    ]